@@ -0,0 +1,61 @@
+# Writes EmbeddedAssetData.inc for src/Core/EmbeddedAssets.cpp, run as a script when building with EMBED_ASSETS:
+#   cmake -DSOURCE_DIR=<repository> -DOUTPUT=<file> -P EmbedAssets.cmake
+# Every shader becomes a null terminated char array, every level a char array parsed and
+# checked by LevelText at compile time, so a broken level fails the build.
+
+file(GLOB SHADER_FILES ${SOURCE_DIR}/shaders/*)
+file(GLOB LEVEL_FILES ${SOURCE_DIR}/levels/*)
+list(FILTER LEVEL_FILES EXCLUDE REGEX "\\.(nexthop|lvlc)$")
+list(SORT SHADER_FILES)
+list(SORT LEVEL_FILES)
+
+# CMake regular expressions have no {16}
+set(SIXTEEN_BYTES "")
+foreach(I RANGE 15)
+  string(APPEND SIXTEEN_BYTES "0x[0-9a-f][0-9a-f], ")
+endforeach()
+
+# The bytes of a file as "0x..," with 16 per line, followed by the terminating 0
+function(embed_bytes FILE_PATH INDENT OUT_VAR)
+  file(READ ${FILE_PATH} HEX HEX)
+  string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1, " BYTES "${HEX}")
+  string(REGEX REPLACE "(${SIXTEEN_BYTES})" "\\1\n${INDENT}" BYTES "${BYTES}")
+  string(REPLACE ", \n" ",\n" BYTES "${BYTES}")
+  # Bytes above 127 are cast, they would be narrowing into a char otherwise
+  string(REGEX REPLACE "0x([89a-f][0-9a-f])" "(char)0x\\1" BYTES "${BYTES}")
+  set(${OUT_VAR} "${BYTES}0" PARENT_SCOPE)
+endfunction()
+
+set(CONTENT "// Generated by cmake/EmbedAssets.cmake, do not edit\n\nnamespace {\n")
+set(FILE_TABLE "")
+set(LEVEL_TABLE "")
+
+foreach(SHADER_FILE ${SHADER_FILES})
+  get_filename_component(NAME ${SHADER_FILE} NAME)
+  string(MAKE_C_IDENTIFIER "shader_${NAME}" ID)
+  embed_bytes(${SHADER_FILE} "\t\t" BYTES)
+  string(APPEND CONTENT "\tconstexpr char ${ID}[] = {\n\t\t${BYTES}\n\t};\n\n")
+  string(APPEND FILE_TABLE "\t\t{ \"shaders/${NAME}\", ${ID}, sizeof(${ID}) - 1 },\n")
+endforeach()
+
+foreach(LEVEL_FILE ${LEVEL_FILES})
+  get_filename_component(NAME ${LEVEL_FILE} NAME)
+  string(MAKE_C_IDENTIFIER "level_${NAME}" ID)
+  embed_bytes(${LEVEL_FILE} "\t\t\t" BYTES)
+  string(APPEND CONTENT
+    "\tnamespace ${ID} {\n"
+    "\t\tconstexpr char text[] = {\n\t\t\t${BYTES}\n\t\t};\n"
+    "\t\tconstexpr LevelText::Level<LevelText::tileCount(text)> level = LevelText::parse<LevelText::tileCount(text)>(text);\n"
+    "\t\tstatic_assert(level.width > 0 && level.height > 0, \"levels/${NAME}: expected <width>x<height> on the first line\");\n"
+    "\t\tstatic_assert(level.valid, \"levels/${NAME}: the rows do not match the size on the first line\");\n"
+    "\t\tstatic_assert(LevelText::count(level, 2) == 1, \"levels/${NAME}: expected exactly one player spawn (2)\");\n"
+    "\t\tstatic_assert(LevelText::ghostsPlacedOnce(level), \"levels/${NAME}: expected every ghost ID from 3 up to the highest on exactly one tile\");\n"
+    "\t}\n\n")
+  string(APPEND LEVEL_TABLE "\t\t{ \"levels/${NAME}\", ${ID}::level.tiles, ${ID}::level.width, ${ID}::level.height },\n")
+endforeach()
+
+string(APPEND CONTENT
+  "\tconst EmbeddedFile embeddedFiles[] = {\n${FILE_TABLE}\t\t{ nullptr, nullptr, 0 }\n\t};\n\n"
+  "\tconst EmbeddedLevel embeddedLevels[] = {\n${LEVEL_TABLE}\t\t{ nullptr, nullptr, 0, 0 }\n\t};\n}\n")
+
+file(WRITE ${OUTPUT} "${CONTENT}")
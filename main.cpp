@@ -3,9 +3,12 @@
 
 #include "src/Core/ScenarioLoader.h"
 #include "src/Core/Renderer.h"
+#include "src/Sim/GameSim.h"
 #include "src/Maze3D/Pellet3D.h"
 #include "src/Maze3D/Ghost3D.h"
 #include "src/Core/Minimap.h"
+#include "src/Core/GpuDistanceField.h"
+#include "src/Core/Vfs.h"
 
 #include <set>
 #include <iostream>
@@ -23,7 +26,8 @@ void GLAPIENTRY MessageCallback(GLenum source,
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
-void processInput(GLFWwindow* window, std::vector<std::vector<int>> m_Map2d, bool m_ConstrainMovement);
+void processInput(GLFWwindow* window, GameSim* sim);
+void updateGpuRoutes(GpuDistanceField* field, GameSim* sim);
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 
 Camera* camera;
@@ -40,9 +44,22 @@ bool gameover = false;
 // timing
 float deltaTime = 0.0f;	// time between current frame and last frame
 float lastFrame = 0.0f;
+float accumulator = 0.0f;	// time not yet consumed by the simulation
 
+const float SIM_TIMESTEP = 1.f / 120.f;	// the game logic always advances in steps of this size
+const int	MAX_SIM_STEPS = 8;				// upper bound of steps per frame, avoids spiraling after a stall
+const int	AI_BUDGET_US = 1000;			// microseconds of ghost pathfinding per frame, the rest waits for the next frame
+const int	GPU_ROUTE_STEPS = 16;			// steps of every ghost's route read back from the gpu distance field
+
+
+int main(int argc, char** argv) {
+    // --gpu-pathfinding computes the distance field towards the player with compute shaders
+    bool gpuPathfinding = argc > 1 && std::string(argv[1]) == "--gpu-pathfinding";
+
+    // Textures, sprites, models and shaders are read from the pack written by assetpack,
+    // anything missing from it (or all of it, without a pack) from the res and shaders folders
+    Vfs::mount("assets.pak");
 
-int main() {
     // Initialization of GLFW
     if (!glfwInit())
     {
@@ -103,32 +120,48 @@ int main() {
     const GLuint SHADOW_HEIGHT = 1024;
 
     ScenarioLoader  scenario("levels/level0");
+    if (!scenario.isLoaded())
+    {
+        // The loader has printed the line and column of the problem
+        glfwTerminate();
+        std::cin.get();
+
+        return EXIT_FAILURE;
+    }
+    GameSim         sim(&scenario, scenario.countGhosts());
+    sim.setPathBudget(AI_BUDGET_US);
+    if (sim.getUnreachablePellets() > 0)
+        std::cout << "Level has " << sim.getUnreachablePellets() << " tiles the player can not reach, no pellets placed on them\n";
     Shader          shader("shaders/maze.vs", "shaders/maze.fs");
     Renderer        renderer;
     Maze3D          maze(&scenario,&shader,&renderer);
-    camera =        new Camera(maze.findSpawn());
+    camera =        new Camera(sim.getPlayer().position);
+
+    GpuDistanceField* gpuField = nullptr;
+    if (gpuPathfinding && GpuDistanceField::isSupported()) {
+        gpuField = new GpuDistanceField(sim.getMap());
+        sim.setPathPlanner(PathPlanner::External);
+    }
 
     Shader pelletShader("shaders/pellet.vs", "shaders/pellet.fs");
     Model pellet("res/pellet/pellet.obj");
-    Pellet3D pellets(&pellet, &maze);
+    Pellet3D pellets(&pellet, &sim);
 
     Model ghost("res/ghost/Ghost.obj");
 
-    AStar pathfinder(&maze);
-
     std::vector<Shader*>     ghostShaders;
     std::vector<Ghost3D*>    ghosts;
 
-    for (int i = 0; i < 3; i++) {
+    for (int i = 0; i < sim.getGhosts().size(); i++) {
         ghostShaders.push_back(new Shader("shaders/ghost.vs", "shaders/ghost.fs"));
-        ghosts.push_back(new Ghost3D(&ghost, &maze, 3 + i, camera, &pathfinder));
+        ghosts.push_back(new Ghost3D(&ghost, &sim.getGhosts()[i]));
     }
 
 
     Shader minimapShader("shaders/minimap.vs", "shaders/minimap.fs");
     Shader maze2DShader("shaders/maze2D.vs", "shaders/maze2D.fs");
 
-    Minimap minimap(&scenario,&maze2DShader,&renderer, &minimapShader, &maze, camera, ghosts);
+    Minimap minimap(&scenario,&maze2DShader,&renderer, &minimapShader, &maze, camera, &sim);
 
 
 
@@ -141,7 +174,22 @@ int main() {
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
-        processInput(window, maze.getMap(),constrainMovement);
+        processInput(window, &sim);
+
+        //Advance the game logic in fixed steps, the rendering below only reads from the sim
+        accumulator += deltaTime;
+        sim.beginFrame();
+        if (gpuField)
+            updateGpuRoutes(gpuField, &sim);
+        for (int steps = 0; accumulator >= SIM_TIMESTEP; steps++) {
+            if (steps == MAX_SIM_STEPS) {
+                accumulator = 0.0f;
+                break;
+            }
+            sim.tick(SIM_TIMESTEP);
+            accumulator -= SIM_TIMESTEP;
+        }
+        camera->Position = sim.getPlayer().position;
 
         glClearColor(0.1f, 0.1f, 0.2f, 1.f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -157,22 +205,19 @@ int main() {
         maze.Light(deltaTime, *camera);
         maze.draw(projection, view, deltaTime);
 
-        pellets.eatPellet(camera, &maze);
-        pellets.Draw(&pelletShader, projection, view);
-        if (pellets.allEaten)
-            gameover = true;
+        pellets.Draw(&pelletShader, projection, view, maze.getVisibility());
 
-        for (int i = 0; i < 3; i++) {
-            ghosts[i]->Draw(ghostShaders[i], projection, view, deltaTime,constrainMovement);
-            if (ghosts[i]->playerEaten)
-                gameover = true;
-        }
+        for (int i = 0; i < ghosts.size(); i++)
+            ghosts[i]->Draw(ghostShaders[i], projection, view, maze.getVisibility());
 
         minimap.Draw(&minimapShader, deltaTime);
 
+        if (sim.isGameOver())
+            gameover = true;
+
         if (gameover) {
-            std::cout << "\nYou ate " << maze.getPelletCount() - pellets.pelletCount 
-                      << '/' << maze.getPelletCount() << " pellets!" << std::endl;
+            std::cout << "\nYou ate " << sim.getPelletCount() - sim.getRemainingPellets() 
+                      << '/' << sim.getPelletCount() << " pellets!" << std::endl;
             break;
         }
 
@@ -190,19 +235,45 @@ int main() {
 
 // process all input: query GLFW whether relevant keys are pressed/released this frame and react accordingly
 // ---------------------------------------------------------------------------------------------------------
-void processInput(GLFWwindow* window, std::vector<std::vector<int>> m_Map2d, bool m_ConstrainMovement)
+void processInput(GLFWwindow* window, GameSim* sim)
 {
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 
+    glm::vec3 wishMove(0.0f);
     if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-        camera->ProcessKeyboard(FORWARD, deltaTime, m_Map2d, m_ConstrainMovement);
+        wishMove += camera->ProcessKeyboard(FORWARD);
     if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-        camera->ProcessKeyboard(BACKWARD, deltaTime, m_Map2d, m_ConstrainMovement);
+        wishMove += camera->ProcessKeyboard(BACKWARD);
     if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-        camera->ProcessKeyboard(LEFT, deltaTime, m_Map2d, m_ConstrainMovement);
+        wishMove += camera->ProcessKeyboard(LEFT);
     if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-        camera->ProcessKeyboard(RIGHT, deltaTime, m_Map2d, m_ConstrainMovement);
+        wishMove += camera->ProcessKeyboard(RIGHT);
+
+    sim->setPlayerInput(wishMove);
+    sim->setConstrainMovement(constrainMovement);
+}
+
+// rebuilds the gpu distance field when the player has changed tile, and gives every ghost the route read back from it
+// ---------------------------------------------------------------------------------------------------------
+void updateGpuRoutes(GpuDistanceField* field, GameSim* sim)
+{
+    int goalY = floor(sim->getPlayer().position.z);
+    int goalX = floor(sim->getPlayer().position.x);
+    if (goalY != field->getGoalY() || goalX != field->getGoalX())
+        field->build(goalY, goalX);
+    if (field->getGoalY() == -1)    // the player is outside the level, the ghosts keep the routes they have
+        return;
+
+    std::vector<int> cellsY, cellsX;
+    for (const auto& ghost : sim->getGhosts()) {
+        cellsY.push_back(floor(ghost.posY));
+        cellsX.push_back(floor(ghost.posX));
+    }
+    std::vector<FlowStep> steps;
+    field->getRoutes(cellsY, cellsX, GPU_ROUTE_STEPS, steps);
+    for (size_t i = 0; i < cellsY.size(); i++)
+        sim->setGhostRoute(i, cellsY[i], cellsX[i], goalY, goalX, &steps[i * GPU_ROUTE_STEPS], GPU_ROUTE_STEPS);
 }
 
 // glfw: whenever the window size changed (by OS or user resize) this callback function executes
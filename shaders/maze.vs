@@ -1,7 +1,5 @@
 #version 430 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec2 aTexCoords;
+layout (location = 0) in uvec4 aVertex;   // a packed Vertex: x and z plus 2, u, v | face << 1
 
 out vec3 FragPos;
 out vec3 Normal;
@@ -11,11 +9,20 @@ uniform mat4 u_TransformationMat;
 uniform mat4 u_ViewMat;
 uniform mat4 u_ProjectionMat;
 
+const uint FLOOR = 4u;
+const vec3 DIRECTIONS[4] = vec3[](vec3(1, 0, 0), vec3(-1, 0, 0), vec3(0, 0, -1), vec3(0, 0, 1));
+
 void main()
 {
+    uint v = aVertex.w & 1u;
+    uint face = aVertex.w >> 1;
+    vec3 aPos = vec3(float(aVertex.x) - 2.0, face == FLOOR ? -0.1 : float(v), float(aVertex.y) - 2.0);
+    // the normal has always been the position moved one step out of the face
+    vec3 aNormal = face == FLOOR ? vec3(aPos.x, 1.0, aPos.z) : aPos + DIRECTIONS[face];
+
     FragPos = vec3(u_TransformationMat * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(u_TransformationMat))) * aNormal;  
-    TexCoords = aTexCoords;
-    
+    Normal = mat3(transpose(inverse(u_TransformationMat))) * aNormal;
+    TexCoords = vec2(float(aVertex.z), float(v));
+
     gl_Position = u_ProjectionMat * u_ViewMat * vec4(FragPos, 1.0);
-}
\ No newline at end of file
+}
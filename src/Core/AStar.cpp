@@ -10,21 +10,30 @@
  */
 #include "AStar.h"
 #include <vector>
-#include <queue>
-#include <stack>
+#include <algorithm>
+#include <cstdlib>
 
 /**
- * @brief Construct a new AStar::AStar object.
+ * @brief Construct a new BasicAStar object.
  * 
- * @param maze - The maze in which the Astar algorithm will do its pathfinding. 
+ * @param map - The 2d grid of the maze in which the Astar algorithm will do its pathfinding. 
+ * @param mode - Wheter to expand every neighbour or only jump points, can be changed later
  */
-AStar::AStar(Maze3D* maze)
-	:	m_maze(maze),
-		height(maze->getHeight()),
-		width(maze->getWidth())
+template<typename OpenList>
+BasicAStar<OpenList>::BasicAStar(MazeGrid map, SearchMode mode)
+	:	m_map(map),
+		m_mode(mode),
+		height(map.getHeight()),
+		width(map.getWidth()),
+		expansions(0),
+		generation(0)
 {
-	nodeMap.resize(height, std::vector<Node>(width));
-	closedList.resize(height, std::vector<bool>(width));
+	cellCount = height * width;
+	scratch.assign(3 * cellCount, 0);
+	stamp	= &scratch[0];
+	gCost	= stamp + cellCount;
+	parent	= gCost + cellCount;
+	openList.reserve(cellCount);
 }
 
 /**
@@ -36,22 +45,27 @@ AStar::AStar(Maze3D* maze)
  * @param destination - The node of which we are calculating remaining distance too
  * @return 	returns the calculated heuristic distance.
  */
-float AStar::calculateHeuristic(int y, int x, Node destination)
+template<typename OpenList>
+float BasicAStar<OpenList>::calculateHeuristic(int y, int x, Node destination)
 {
 	return (abs(y - destination.y) + abs(x - destination.x));
 }
 
 /**
  * @brief Checks wheter or not any given node is traversable (Can be walked on/through).
+ * 		  Nodes outside of the map are never traversable.
  * 
  * @param y - The y coordinate for the node we are checking
  * @param x - The x coordinate for the node we are checking
  * @return true - The tile can be traversed
  * @return false - The tile is not traversable.
  */
-bool AStar::isValid(int y, int x)
+template<typename OpenList>
+bool BasicAStar<OpenList>::isValid(int y, int x)
 {
-	return (m_maze->map2d[y][x] != 1);
+	if (y < 0 || y >= height || x < 0 || x >= width)
+		return false;
+	return (m_map(y, x) != 1);
 }
 
 /**
@@ -63,148 +77,362 @@ bool AStar::isValid(int y, int x)
  * @return true 
  * @return false 
  */
-bool AStar::isDestination(int y, int x, Node destination)
+template<typename OpenList>
+bool BasicAStar<OpenList>::isDestination(int y, int x, Node destination)
 {
 	return (y == destination.y && x == destination.x);
 }
 
+/**
+ * @brief 	Starts a new query. Instead of clearing the scratch buffer every cell is
+ * 			stamped with the generation it was last touched in, anything with an older
+ * 			stamp counts as undiscovered. The buffer is only cleared when the counter wraps.
+ * 
+ */
+template<typename OpenList>
+void BasicAStar<OpenList>::nextGeneration()
+{
+	generation += 2; //generation: discovered, generation + 1: closed
+	if (generation < 2) {
+		std::fill(stamp, stamp + cellCount, 0u);
+		generation = 2;
+	}
+	openList.clear();
+}
+
+/**
+ * @brief Builds the output node for a cell on the path.
+ * 
+ * @param index 		- y * width + x of the cell
+ * @param parentIndex 	- y * width + x of the cell before it on the path
+ * @param g 			- The amount of steps from the start to the cell
+ * @param destination 	- The destination of the query, used for the heuristics
+ * @return Node 
+ */
+template<typename OpenList>
+Node BasicAStar<OpenList>::makeNode(unsigned int index, unsigned int parentIndex, unsigned int g, Node destination)
+{
+	Node node;
+	node.y = index / width;
+	node.x = index % width;
+	node.parentY = parentIndex / width;
+	node.parentX = parentIndex % width;
+	node.gCost = g;
+	node.hCost = calculateHeuristic(node.y, node.x, destination);
+	node.fCost = node.gCost + node.hCost;
+	return node;
+}
+
 /**
  * @brief 	Will generate a path by backtracking its way back from the destination 
- * 			to the start node
+ * 			to the start node. The path is written straight into the callers buffer
+ * 			from start to destination, if it does not fit only the first part is written.
+ * 			In jump point mode the parent of a cell can be several cells away in a straight
+ * 			line, the cells in between are filled in so both modes give the same output.
  * 
- * @param destination 	The node from which we are going to start our backtracking.
- * @return vector<Node>  A std::vector containing the calculated path.
+ * @param destination 	- The node from which we are going to start our backtracking.
+ * @param pathBuffer 	- Caller owned buffer the path is written to
+ * @param bufferSize 	- How many nodes fit in pathBuffer
+ * @return int 			- The length of the whole path, including the start node
  */
-vector<Node> AStar::makePath(Node destination)
+template<typename OpenList>
+int BasicAStar<OpenList>::makePath(Node destination, Node* pathBuffer, int bufferSize)
 {
-	int y = destination.y;
-	int x = destination.x;
+	unsigned int goal = destination.y * width + destination.x;
+
+	//The amount of steps is known from the cost, every step costs 1.
+	int length = gCost[goal] + 1;
 
-	std::stack <Node> path;
-	std::vector <Node> pathFromStart;
-	while (!(nodeMap[y][x].parentY == y && nodeMap[y][x].parentX == x)
-		&& (nodeMap[y][x].y != 1 && nodeMap[y][x].x != -1))
+	int y = destination.y, x = destination.x;
+	unsigned int target = parent[goal];	//the next cell we stored on the way back
+	for (int i = length - 1; i >= 0; i--) //Backtrack our way to the start node.
 	{
-		path.push(nodeMap[y][x]);
-		int fooY = nodeMap[y][x].parentY; //Backtrack our way to the start node.
-		int fooX = nodeMap[y][x].parentX;
-		y = fooY; x = fooX;
+		//Step one cell towards the target, it is always in a straight line
+		int ty = target / width, tx = target % width;
+		int nextY = y + (ty > y) - (ty < y);
+		int nextX = x + (tx > x) - (tx < x);
+		unsigned int index = y * width + x;
+		unsigned int next = nextY * width + nextX;
+
+		if (i < bufferSize)
+			pathBuffer[i] = makeNode(index, i == 0 ? index : next, i, destination);
+
+		y = nextY; x = nextX;
+		if (next == target)
+			target = parent[target];
+	}
+	return length;
+}
+
+/**
+ * @brief 	Adds a cell reached from the current node to the open list, unless it has
+ * 			already been reached through a path that is at least as cheap.
+ * 
+ * @param cell 			- y * width + x of the reached cell
+ * @param from 			- y * width + x of the node it was reached from
+ * @param gNew 			- The cost of reaching the cell through this node
+ * @param destination 	- The destination node
+ * @return true 		- The cell is the destination, the path is complete
+ */
+template<typename OpenList>
+bool BasicAStar<OpenList>::discover(unsigned int cell, unsigned int from, unsigned int gNew, Node destination)
+{
+	int y = cell / width;
+	int x = cell % width;
+	if (isDestination(y, x, destination)) {
+		//Found a path
+		stamp[cell] = generation;
+		gCost[cell] = gNew;
+		parent[cell] = from; //sets the parent node
+		return true;
 	}
-	path.push(nodeMap[y][x]); //Finally, push the start node onto the stack.
 
-	int counter = 0;
-	while (!path.empty()) //While still content on the stack
+	//Node has not been discovered in this query, or this path is better than the current one
+	if (stamp[cell] < generation ||
+		(stamp[cell] == generation && gCost[cell] > gNew))
 	{
-		Node top = path.top();
-		path.pop();
-		//std::cout << counter++ << ": " << top.x << ' ' << top.y << std::endl;
-		pathFromStart.emplace_back(top);
+		stamp[cell] = generation;
+		gCost[cell] = gNew;
+		parent[cell] = from;
+		float fNew = gNew + calculateHeuristic(y, x, destination);
+		openList.push((typename OpenList::Key)fNew, cell); //Add the neighbor to the open list
 	}
-	return pathFromStart; //return the now reversed path going from start -> destination
+	return false;
 }
 
 /**
- * @brief Clear the entire 2d array, preparing it for a fresh calculation of Astar. 
+ * @brief Discovers every walkable neighbour of a node, the regular A* expansion.
  * 
+ * @param index 		- y * width + x of the node being expanded
+ * @param destination 	- The destination node
+ * @return true 		- The destination was reached
  */
-void AStar::resetMap()
+template<typename OpenList>
+bool BasicAStar<OpenList>::expandNeighbours(unsigned int index, Node destination)
 {
-	//initialise our whole nodeMap to "undiscovered"
-	for (int y = 0; y < height; y++)
-		for (int x = 0; x < width; x++) {
-			nodeMap[y][x].fCost = MAX_VALUE;
-			nodeMap[y][x].gCost = MAX_VALUE;
-			nodeMap[y][x].hCost = MAX_VALUE;
-			nodeMap[y][x].parentX = -1;
-			nodeMap[y][x].parentY = -1;
-			nodeMap[y][x].x = x;
-			nodeMap[y][x].y = y;
+	const int offsetY[4] = { -1, 1, 0, 0 }; //"North", "South", "East", "West"
+	const int offsetX[4] = { 0, 0, 1, -1 };
+
+	int y = index / width;
+	int x = index % width;
+	for (int i = 0; i < 4; i++) { //Loop through all directions
+		int newY = y + offsetY[i];
+		int newX = x + offsetX[i];
+		if (!isValid(newY, newX)) //Node is a wall
+			continue;
+		if (discover(newY * width + newX, index, gCost[index] + 1, destination))
+			return true;
+	}
+	return false;
+}
+
+/**
+ * @brief 	Checks if a cell moved into horizontally has a forced neighbour, an open cell
+ * 			above or below it that could not be reached as cheaply without passing through it.
+ * 
+ * @param y 	- The y coordinate of the cell
+ * @param x 	- The x coordinate of the cell
+ * @param dx 	- The horizontal direction the cell was entered in, 1 or -1
+ * @return true - There is a forced neighbour, the cell is a jump point
+ */
+template<typename OpenList>
+bool BasicAStar<OpenList>::hasForcedNeighbour(int y, int x, int dx)
+{
+	return (isValid(y - 1, x) && !isValid(y - 1, x - dx)) ||
+		   (isValid(y + 1, x) && !isValid(y + 1, x - dx));
+}
 
-			closedList[y][x] = false; //setting every node to visited == false
+/**
+ * @brief 	Moves from a cell in a straight line until it reaches a jump point, the
+ * 			destination or a wall. Paths are made canonical by turning vertical as early
+ * 			as possible: horizontal moves stop at forced neighbours, vertical moves stop
+ * 			where a horizontal jump to either side finds a jump point.
+ * 
+ * @param y 			- The y coordinate of the cell to jump from
+ * @param x 			- The x coordinate of the cell to jump from
+ * @param dy 			- Vertical direction, 0 when jumping horizontally
+ * @param dx 			- Horizontal direction, 0 when jumping vertically
+ * @param destination 	- The destination node
+ * @return int 			- y * width + x of the jump point, -1 if a wall was hit first
+ */
+template<typename OpenList>
+int BasicAStar<OpenList>::jump(int y, int x, int dy, int dx, Node destination)
+{
+	while (true) {
+		y += dy;
+		x += dx;
+		if (!isValid(y, x))
+			return -1;
+		if (isDestination(y, x, destination))
+			return y * width + x;
+		if (dx != 0) {
+			if (hasForcedNeighbour(y, x, dx))
+				return y * width + x;
 		}
+		else if (jump(y, x, 0, 1, destination) != -1 || jump(y, x, 0, -1, destination) != -1)
+			return y * width + x;
+	}
+}
+
+/**
+ * @brief 	Discovers the jump points reachable from a node. The direction the node was
+ * 			entered in prunes the directions that are searched: a horizontal move only
+ * 			continues forward and towards its forced neighbours, a vertical move continues
+ * 			forward and to both sides. The start node searches all four directions.
+ * 
+ * @param index 		- y * width + x of the node being expanded
+ * @param destination 	- The destination node
+ * @return true 		- The destination was reached
+ */
+template<typename OpenList>
+bool BasicAStar<OpenList>::expandJumpPoints(unsigned int index, Node destination)
+{
+	int y = index / width;
+	int x = index % width;
+	int py = parent[index] / width;
+	int px = parent[index] % width;
+	int dy = (y > py) - (y < py);
+	int dx = (x > px) - (x < px);
+
+	int directions[4][2];
+	int count = 0;
+	if (dy == 0 && dx == 0) { //the start node
+		directions[count][0] = -1; directions[count++][1] = 0;
+		directions[count][0] = 1;  directions[count++][1] = 0;
+		directions[count][0] = 0;  directions[count++][1] = -1;
+		directions[count][0] = 0;  directions[count++][1] = 1;
+	}
+	else if (dx != 0) {
+		directions[count][0] = 0; directions[count++][1] = dx;
+		if (isValid(y - 1, x) && !isValid(y - 1, x - dx)) { //forced neighbours
+			directions[count][0] = -1; directions[count++][1] = 0;
+		}
+		if (isValid(y + 1, x) && !isValid(y + 1, x - dx)) {
+			directions[count][0] = 1; directions[count++][1] = 0;
+		}
+	}
+	else {
+		directions[count][0] = dy; directions[count++][1] = 0;
+		directions[count][0] = 0;  directions[count++][1] = -1;
+		directions[count][0] = 0;  directions[count++][1] = 1;
+	}
+
+	for (int i = 0; i < count; i++) {
+		int jumpPoint = jump(y, x, directions[i][0], directions[i][1], destination);
+		if (jumpPoint == -1)
+			continue;
+		unsigned int distance = abs(jumpPoint / width - y) + abs(jumpPoint % width - x);
+		if (discover(jumpPoint, index, gCost[index] + distance, destination))
+			return true;
+	}
+	return false;
 }
 
 /**
  * @brief 	The actual algorithm for calculating the shortest path from any given node start
- * 			to any given node destination. 
+ * 			to any given node destination. The result is left in the scratch buffer.
  * 
- * @param start - The start node.
- * @param destination - The destination node. 
- * @return std::vector<Node> Will return the result std::vector of nodes from start to the destination.
- * @return std::vector<Node> Can also return an empty std::vector if there was no path available. 
+ * @param start 		- The start node.
+ * @param destination 	- The destination node. 
+ * @return true 		- A path was found
+ * @return false 		- There is no path, or start and destination is the same node
  */
-std::vector<Node> AStar::Pathfind(Node start, Node destination)
+template<typename OpenList>
+bool BasicAStar<OpenList>::search(Node start, Node destination)
 {
-	resetMap();
-	std::vector<Node> empty;
+	nextGeneration();
+	expansions = 0;
 	if (isDestination(start.y, start.x, destination))
-		return empty;
+		return false;
 	//If the start node and the destination is the same, we have already found
-	//our path and therefore we simply return an empty vector
+	//our path and therefore there is nothing to return
+	if (start.y < 0 || start.y >= height || start.x < 0 || start.x >= width ||
+		!isValid(destination.y, destination.x))
+		return false;
 
 	//initialise our starting list
-	int x = start.x;
-	int y = start.y;
-	nodeMap[y][x].fCost = 0.0f;
-	nodeMap[y][x].gCost = 0.0f;
-	nodeMap[y][x].hCost = 0.0f;
-	nodeMap[y][x].parentX = x;
-	nodeMap[y][x].parentY = y;
-
-	//We sort the priority queue based on the fCost of a given Node, making sure
-	//that the node with the currently shortest total cost is popped first.
-	std::priority_queue <Node, vector<Node>, CompareFCost> openList;
-	openList.push(nodeMap[y][x]); //Push the start node onto the queue
+	unsigned int index = start.y * width + start.x;
+	stamp[index] = generation;
+	gCost[index] = 0;
+	parent[index] = index;
 
-	bool destinationFound = false; //Has destination been found?
+	//The open list is sorted on the fCost of a given node, making sure
+	//that the node with the currently shortest total cost is popped first.
+	openList.push(0, index); //Push the start node onto the open list
 
 	while (!openList.empty()) {
-		Node node = openList.top(); //Picks the lowest fCost element in the queue.
-		openList.pop();				//Pops it off the queue
-		
-		x = node.x;
-		y = node.y;
-		closedList[y][x] = true;	//Marks the current location as visited.
-
-		for (int i = 0; i < 4; i++) { //Loop through all directions
-			int newY = 0, newX = 0; //Reset for each iteration
-			switch (i) {
-			case 0: newY--; break; //Check "North"
-			case 1: newY++; break; //Check "South"
-			case 2: newX++; break; //Check "East"
-			case 3: newX--; break; //Check "West"
-			default: break;
-			}
-			float gNew, hNew, fNew;
-			if (isValid(y + newY, x + newX)) //Node is not a wall
-				if (isDestination(y + newY, x + newX, destination)) { //Node is not the destination
-					//Found a path
-					nodeMap[y + newY][x + newX].parentY = y; //sets the parent node
-					nodeMap[y + newY][x + newX].parentX = x;
-					destinationFound = true;
-					return makePath(destination);
-				} else if (closedList[y + newY][x + newX] == false) { //Node has not been visited
-					gNew = node.gCost + 1.f;
-					hNew = calculateHeuristic(y + newY, x + newX, destination);
-					fNew = gNew + hNew;
-					//Checks if this path is better than the current one
-					if (nodeMap[y + newY][x + newX].fCost == MAX_VALUE ||
-						nodeMap[y + newY][x + newX].fCost > fNew) 
-					{
-						//Update the neighbour nodes data
-						nodeMap[y + newY][x + newX].fCost = fNew;
-						nodeMap[y + newY][x + newX].gCost = gNew;
-						nodeMap[y + newY][x + newX].hCost = hNew;
-						nodeMap[y + newY][x + newX].parentY = y;
-						nodeMap[y + newY][x + newX].parentX = x;
-						openList.push(nodeMap[y + newY][x + newX]); //Add the neighbor to the queue
-					}
-				}
-		}
-	}
-	if (!destinationFound) {
-		std::cout << "Destination not found!\n";
-		return empty;
+		index = openList.pop(); //Picks the lowest fCost element
+
+		if (stamp[index] == generation + 1) //Already expanded through a cheaper entry
+			continue;
+		stamp[index] = generation + 1;	//Marks the current location as visited.
+		expansions++;
+
+		bool found = (m_mode == SearchMode::JumpPoint) ? expandJumpPoints(index, destination)
+													   : expandNeighbours(index, destination);
+		if (found)
+			return true;
 	}
+	return false;
+}
 
+/**
+ * @brief 	Calculates the shortest path and writes it into a caller owned buffer.
+ * 			Does not allocate any memory.
+ * 
+ * @param start 		- The start node.
+ * @param destination 	- The destination node. 
+ * @param pathBuffer 	- Caller owned buffer the path is written to, start node first
+ * @param bufferSize 	- How many nodes fit in pathBuffer
+ * @return int 			- The length of the whole path, 0 if there was no path available
+ */
+template<typename OpenList>
+int BasicAStar<OpenList>::Pathfind(Node start, Node destination, Node* pathBuffer, int bufferSize)
+{
+	if (!search(start, destination))
+		return 0;
+	return makePath(destination, pathBuffer, bufferSize);
+}
+
+/**
+ * @brief 	Calculates the shortest path, but only returns the first step along it.
+ * 			Does not allocate any memory.
+ * 
+ * @param start 		- The start node.
+ * @param destination 	- The destination node. 
+ * @param next 			- Is set to the node following start on the path
+ * @return true 		- A path was found
+ * @return false 		- There is no path, or start and destination is the same node
+ */
+template<typename OpenList>
+bool BasicAStar<OpenList>::NextStep(Node start, Node destination, Node& next)
+{
+	Node path[2];
+	if (Pathfind(start, destination, path, 2) < 2)
+		return false;
+	next = path[1];
+	return true;
+}
+
+/**
+ * @brief 	Calculates the shortest path from any given node start to any given node destination. 
+ * 
+ * @param start - The start node.
+ * @param destination - The destination node. 
+ * @return std::vector<Node> Will return the result std::vector of nodes from start to the destination.
+ * @return std::vector<Node> Can also return an empty std::vector if there was no path available. 
+ */
+template<typename OpenList>
+std::vector<Node> BasicAStar<OpenList>::Pathfind(Node start, Node destination)
+{
+	std::vector<Node> path;
+	if (!search(start, destination))
+		return path;
+	path.resize(gCost[destination.y * width + destination.x] + 1);
+	makePath(destination, &path[0], path.size());
+	return path; //the path going from start -> destination
 }
+
+//The open lists AStar can be compiled with
+template class BasicAStar<BinaryHeap>;
+template class BasicAStar<BucketQueue>;
@@ -4,12 +4,15 @@
  * @brief Header file for the Astar class.
  * @version 0.1
  * @date 2020-11-17
- * 
+ *
  * @copyright Copyright (c) 2020
- * 
+ *
  */
 #pragma once
-#include "../Maze3D/Maze3D.h"
+#include "OpenList.h"
+#include "MazeGrid.h"
+
+#include <vector>
 
 /**
  * @brief A structure holding data regarding any given node in the map. Used for pathfinding.
@@ -25,39 +28,68 @@ struct Node {
 };
 
 /**
- * @brief A struct containing the function for comparing two nodes, used in combination
- * 		  with the priority_queue we are using for keeping track of nodes. 
- * 
+ * @brief 	How the search expands a node. Standard discovers every neighbour, JumpPoint
+ * 			only discovers the jump points found by scanning in straight lines (JPS on a
+ * 			4-connected grid), which keeps the open list small on large open levels.
  */
-struct CompareFCost {
-	bool operator()(Node const& n1, Node const& n2) {
-		return n1.fCost > n2.fCost; //compares the combined value of travelled distance and heuristics in any given node
-	}
+enum class SearchMode {
+	Standard,
+	JumpPoint
 };
 
 /**
  * @class Astar -	Handling pathfinding from one node to another in a 2 dimensional
 					grid, in this case the level file.
- * @brief	- Will calculate the best (shortest) path from point A to point B. 
+ * @brief	- Will calculate the best (shortest) path from point A to point B.
+ * 			  All per query state lives in one flat scratch buffer which is stamped with a
+ * 			  generation counter, so nothing has to be cleared or allocated between queries.
+ * 			  The open list is chosen at compile time, AStar uses the BucketQueue since every
+ * 			  step on the grid costs 1, BinaryHeap also works with non integer costs.
+ *
+ * @tparam OpenList - BucketQueue or BinaryHeap, see OpenList.h
 */
-class AStar
+template<typename OpenList>
+class BasicAStar
 {
 public:
-	AStar(Maze3D* maze);
+	BasicAStar(MazeGrid map, SearchMode mode = SearchMode::Standard);
 	std::vector<Node> Pathfind(Node start, Node destination);
+	int  Pathfind(Node start, Node destination, Node* pathBuffer, int bufferSize);
+	bool NextStep(Node start, Node destination, Node& next);
 
-	std::vector<std::vector<Node>> nodeMap;
-	std::vector<std::vector<bool>> closedList;
-private:
-	Maze3D* m_maze;
+	inline void setMode(SearchMode mode) { m_mode = mode; }
+	inline SearchMode getMode() const { return m_mode; }
+	inline int getLastExpansions() const { return expansions; }
 
+private:
+	MazeGrid m_map;
+	SearchMode m_mode;
 
 	int height, width;
-	int MAX_VALUE = 999;
+	int cellCount;
+	int expansions;		//nodes popped by the last search
+
+	//Structure of arrays, each array is cellCount long and indexed by y * width + x
+	std::vector<unsigned int> scratch;
+	unsigned int* stamp;	//generation the cell was discovered in, +1 once it is closed
+	unsigned int* gCost;
+	unsigned int* parent;
+	unsigned int  generation;
+
+	OpenList openList;	//keeps its capacity between queries
 
 	float calculateHeuristic(int y, int x, Node destination);
 	bool  isValid(int y, int x);
 	bool  isDestination(int y, int x, Node destination);
-	vector<Node> makePath(Node destination);
-	void resetMap();
-};
\ No newline at end of file
+	bool  search(Node start, Node destination);
+	bool  discover(unsigned int cell, unsigned int from, unsigned int gNew, Node destination);
+	bool  expandNeighbours(unsigned int index, Node destination);
+	bool  expandJumpPoints(unsigned int index, Node destination);
+	bool  hasForcedNeighbour(int y, int x, int dx);
+	int   jump(int y, int x, int dy, int dx, Node destination);
+	int   makePath(Node destination, Node* pathBuffer, int bufferSize);
+	Node  makeNode(unsigned int index, unsigned int parentIndex, unsigned int g, Node destination);
+	void  nextGeneration();
+};
+
+typedef BasicAStar<BucketQueue> AStar;
@@ -10,8 +10,9 @@
  */
 
 #include "Animator.h"
-#include <fstream>
+#include "Vfs.h"
 #include <iostream>
+#include <sstream>
 
 /**
  * @brief Construct a new Animator:: Animator object
@@ -20,7 +21,9 @@
  */
 Animator::Animator(std::string filepaths)
 {
-	std::ifstream spriteLocations(filepaths);
+	std::string spriteList;
+	Vfs::read(filepaths, spriteList);
+	std::istringstream spriteLocations(spriteList);
 
 	spriteLocations >> spriteCount; spriteLocations.ignore();
 
@@ -0,0 +1,224 @@
+/**
+ * @file AssetPack.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class for reading and writing asset packs.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "AssetPack.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace {
+	const uint32_t VERSION = 1;
+	const uint64_t FILE_ALIGNMENT = 16;	//every file starts at a multiple of this
+
+	enum Compression : uint32_t {
+		Stored = 0,
+		Zlib = 1
+	};
+
+	/**
+	 * @brief The header at the start of the pack.
+	 */
+	struct PackHeader {
+		char		magic[4];	//"PMPK"
+		uint32_t	version,
+					fileCount,
+					pathBytes;	//size of the paths following the index
+	};
+
+	/**
+	 * @brief One entry of the index following the header, sorted by path.
+	 */
+	struct PackEntry {
+		uint64_t	offset,			//from the start of the pack
+					storedBytes,	//in the pack
+					bytes;			//once uncompressed
+		uint32_t	pathOffset,		//into the paths
+					pathLength,
+					compression,
+					reserved;
+	};
+
+	inline uint64_t align(uint64_t offset) { return (offset + FILE_ALIGNMENT - 1) / FILE_ALIGNMENT * FILE_ALIGNMENT; }
+
+	inline int comparePath(const char* path, size_t length, const std::string& other)
+	{
+		int order = std::memcmp(path, other.data(), std::min(length, other.size()));
+		if (order != 0)
+			return order;
+		return length < other.size() ? -1 : (length > other.size() ? 1 : 0);
+	}
+}
+
+/**
+ * @brief 	Construct a new AssetPack::AssetPack object, mapping the pack and checking that
+ * 			the index and every file fit in it.
+ *
+ * @param filepath - The pack, isLoaded() is false if it is missing or broken
+ */
+AssetPack::AssetPack(const std::string& filepath)
+	:	file(new MappedFile(filepath)),
+		loaded(false),
+		fileCount(0),
+		entries(nullptr),
+		paths(nullptr),
+		pathBytes(0)
+{
+	const char* data = file->getData();
+	size_t size = file->getSize();
+	if (data == nullptr || size < sizeof(PackHeader))
+		return;
+
+	PackHeader header;
+	std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.magic, "PMPK", 4) != 0 || header.version != VERSION ||
+		(size - sizeof(PackHeader)) / sizeof(PackEntry) < header.fileCount ||
+		size - sizeof(PackHeader) - sizeof(PackEntry) * header.fileCount < header.pathBytes)
+		return;
+
+	const PackEntry* index = (const PackEntry*)(data + sizeof(PackHeader));
+	for (uint32_t i = 0; i < header.fileCount; i++)
+		if (index[i].offset > size || index[i].storedBytes > size - index[i].offset ||
+			index[i].pathOffset > header.pathBytes || index[i].pathLength > header.pathBytes - index[i].pathOffset ||
+			index[i].compression > Zlib)
+			return;
+
+	fileCount = header.fileCount;
+	entries = index;
+	paths = data + sizeof(PackHeader) + sizeof(PackEntry) * header.fileCount;
+	pathBytes = header.pathBytes;
+	loaded = true;
+}
+
+/**
+ * @brief Destroy the AssetPack::AssetPack object, unmapping the pack.
+ *
+ */
+AssetPack::~AssetPack()
+{
+	delete file;
+}
+
+/**
+ * @brief Finds a file in the index.
+ *
+ * @param path 			- The path of the file
+ * @return const void* 	- Its PackEntry, nullptr if the pack does not have it
+ */
+const void* AssetPack::find(const std::string& path) const
+{
+	const PackEntry* index = (const PackEntry*)entries;
+	uint32_t low = 0, high = fileCount;
+	while (low < high) {
+		uint32_t middle = low + (high - low) / 2;
+		int order = comparePath(paths + index[middle].pathOffset, index[middle].pathLength, path);
+		if (order == 0)
+			return &index[middle];
+		if (order < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	return nullptr;
+}
+
+/**
+ * @brief Copies a file out of the pack, uncompressing it if needed.
+ *
+ * @param path 	- The path of the file
+ * @param data 	- Set to the content of the file
+ * @return true - The pack has the file and it could be read
+ */
+bool AssetPack::read(const std::string& path, std::vector<unsigned char>& data) const
+{
+	const PackEntry* entry = (const PackEntry*)find(path);
+	if (entry == nullptr)
+		return false;
+
+	const unsigned char* stored = (const unsigned char*)file->getData() + entry->offset;
+	if (entry->compression == Stored) {
+		data.assign(stored, stored + entry->storedBytes);
+		return true;
+	}
+
+	data.resize(entry->bytes);
+	uLongf bytes = (uLongf)entry->bytes;
+	if (uncompress(data.data(), &bytes, stored, (uLong)entry->storedBytes) != Z_OK || bytes != entry->bytes) {
+		data.clear();
+		return false;
+	}
+	return true;
+}
+
+/**
+ * @brief 	Writes a pack: the header, the index sorted by path, the paths and then every
+ * 			file, each aligned to 16 bytes. A file is only kept compressed if that saves
+ * 			at least an eighth of it, images are mostly compressed already.
+ *
+ * @param filepath 		- Where to write the pack
+ * @param files 		- The files to pack, sorted by path on return
+ * @param compress 		- Wheter or not to try compressing the files
+ * @param packedBytes 	- Set to the size of the pack, if not nullptr
+ * @return true 		- The pack was written
+ */
+bool AssetPack::save(const std::string& filepath, std::vector<File>& files, bool compress, size_t* packedBytes)
+{
+	std::sort(files.begin(), files.end(), [](const File& a, const File& b) { return a.path < b.path; });
+
+	std::string allPaths;
+	for (const auto& packed : files)
+		allPaths += packed.path;
+
+	std::vector<PackEntry> index;
+	std::vector<std::vector<unsigned char>> compressed(files.size());
+	uint64_t offset = align(sizeof(PackHeader) + sizeof(PackEntry) * files.size() + allPaths.size());
+	uint32_t pathOffset = 0;
+	for (size_t i = 0; i < files.size(); i++) {
+		const std::vector<unsigned char>& data = files[i].data;
+		PackEntry entry = { offset, data.size(), data.size(), pathOffset, (uint32_t)files[i].path.size(), Stored, 0 };
+		if (compress && !data.empty()) {
+			uLongf bytes = compressBound((uLong)data.size());
+			compressed[i].resize(bytes);
+			if (compress2(compressed[i].data(), &bytes, data.data(), (uLong)data.size(), Z_BEST_COMPRESSION) == Z_OK &&
+				bytes <= data.size() - data.size() / 8) {
+				compressed[i].resize(bytes);
+				entry.storedBytes = bytes;
+				entry.compression = Zlib;
+			}
+			else
+				compressed[i].clear();
+		}
+		index.push_back(entry);
+		offset = align(offset + entry.storedBytes);
+		pathOffset += entry.pathLength;
+	}
+
+	std::ofstream out(filepath, std::ios::binary);
+	if (!out)
+		return false;
+
+	PackHeader header = { { 'P', 'M', 'P', 'K' }, VERSION, (uint32_t)files.size(), (uint32_t)allPaths.size() };
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)index.data(), sizeof(PackEntry) * index.size());
+	out.write(allPaths.data(), allPaths.size());
+	uint64_t written = sizeof(PackHeader) + sizeof(PackEntry) * index.size() + allPaths.size();
+	const char padding[FILE_ALIGNMENT] = {};
+	for (size_t i = 0; i < files.size(); i++) {
+		const std::vector<unsigned char>& stored = index[i].compression == Zlib ? compressed[i] : files[i].data;
+		out.write(padding, index[i].offset - written);
+		out.write((const char*)stored.data(), index[i].storedBytes);
+		written = index[i].offset + index[i].storedBytes;
+	}
+	if (packedBytes != nullptr)
+		*packedBytes = written;
+	return (bool)out;
+}
@@ -0,0 +1,63 @@
+/**
+ * @file AssetPack.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the AssetPack class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @class AssetPack
+ * @brief 	Many small asset files packed into one, written by the assetpack tool. The header
+ * 			is followed by an index sorted by path, so a file is found by a binary search
+ * 			without touching the disk, and the files themselves start at multiples of 16
+ * 			bytes. Every file is either stored as it is or compressed with zlib, whichever
+ * 			the packer found worth it. The pack is memory mapped, opening it is the only
+ * 			file access.
+ */
+class AssetPack
+{
+public:
+	/**
+	 * @brief A file to be written by save().
+	 *
+	 */
+	struct File {
+		std::string path;	//with '/' between the folders, e.g. "res/maze.png"
+		std::vector<unsigned char> data;
+	};
+
+	AssetPack(const std::string& filepath);
+	~AssetPack();
+
+	AssetPack(const AssetPack&) = delete;
+	AssetPack& operator=(const AssetPack&) = delete;
+
+	static bool save(const std::string& filepath, std::vector<File>& files, bool compress, size_t* packedBytes = nullptr);
+
+	bool contains(const std::string& path) const { return find(path) != nullptr; }
+	bool read(const std::string& path, std::vector<unsigned char>& data) const;
+
+	inline bool isLoaded() const { return loaded; }
+	inline uint32_t getFileCount() const { return fileCount; }
+
+private:
+	const void* find(const std::string& path) const;
+
+	MappedFile* file;
+	bool loaded;
+	uint32_t fileCount;
+	const void* entries;	//the index, right after the header
+	const char* paths;		//all paths one after another, the index points into them
+	size_t pathBytes;
+};
@@ -0,0 +1,125 @@
+/**
+ * @file BatchPathfinder.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class for running many pathfinding queries in parallel.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "BatchPathfinder.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace {
+	const size_t CHUNK_SIZE = 16;	//queries a thread takes from the counter at a time
+}
+
+/**
+ * @brief Construct a new BatchPathfinder::BatchPathfinder object
+ *
+ * @param map 			- The 2d grid of the maze, must outlive the pathfinder
+ * @param mode 			- The search mode every thread uses
+ * @param threadCount 	- How many threads to use, 0 uses one per hardware thread
+ */
+BatchPathfinder::BatchPathfinder(MazeGrid map, SearchMode mode, unsigned int threadCount)
+	:	m_map(map),
+		m_mode(mode),
+		threads(1)
+{
+	setThreadCount(threadCount);
+}
+
+/**
+ * @brief Destroy the BatchPathfinder::BatchPathfinder object
+ *
+ */
+BatchPathfinder::~BatchPathfinder()
+{
+	for (auto searcher : searchers)
+		delete searcher;
+}
+
+/**
+ * @brief Changes how many threads the next batches are spread over.
+ *
+ * @param threadCount - How many threads to use, 0 uses one per hardware thread
+ */
+void BatchPathfinder::setThreadCount(unsigned int threadCount)
+{
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	threads = threadCount;
+	if (searchers.size() < threads)
+		searchers.resize(threads, nullptr);
+}
+
+/**
+ * @brief 	Calls work for every query index, spread over the threads. The calling thread
+ * 			works as well, and the call returns once every query is done.
+ *
+ * @param count - How many queries there are
+ * @param work 	- Called with the AStar of the thread and the index of the query
+ */
+void BatchPathfinder::forEachQuery(size_t count, const std::function<void(AStar&, size_t)>& work)
+{
+	unsigned int threadCount = std::max(1u, std::min(threads, (unsigned int)((count + CHUNK_SIZE - 1) / CHUNK_SIZE)));
+	std::atomic<size_t> nextQuery(0);
+
+	auto worker = [this, count, &work, &nextQuery](unsigned int thread) {
+		if (!searchers[thread])
+			searchers[thread] = new AStar(m_map, m_mode);
+		AStar& astar = *searchers[thread];
+		while (true) {
+			size_t first = nextQuery.fetch_add(CHUNK_SIZE);
+			if (first >= count)
+				break;
+			size_t last = std::min(first + CHUNK_SIZE, count);
+			for (size_t i = first; i < last; i++)
+				work(astar, i);
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (unsigned int i = 1; i < threadCount; i++)
+		pool.emplace_back(worker, i);
+	worker(0);
+	for (auto& thread : pool)
+		thread.join();
+}
+
+/**
+ * @brief 	Runs every query, but only keeps the length and the first step of each path.
+ * 			Does not allocate anything per query.
+ *
+ * @param queries - The queries to run
+ * @param results - Resized to the amount of queries, result i belongs to query i
+ */
+void BatchPathfinder::FindPaths(const std::vector<PathQuery>& queries, std::vector<PathResult>& results)
+{
+	results.resize(queries.size());
+	forEachQuery(queries.size(), [&queries, &results](AStar& astar, size_t i) {
+		Node path[2];
+		PathResult& result = results[i];
+		result.length = astar.Pathfind(queries[i].start, queries[i].destination, path, 2);
+		result.next = result.length >= 2 ? path[1] : queries[i].start;
+		result.expansions = astar.getLastExpansions();
+	});
+}
+
+/**
+ * @brief Runs every query and keeps the whole paths.
+ *
+ * @param queries 	- The queries to run
+ * @param paths 	- Resized to the amount of queries, path i belongs to query i and is empty if there is none
+ */
+void BatchPathfinder::FindPaths(const std::vector<PathQuery>& queries, std::vector<std::vector<Node>>& paths)
+{
+	paths.resize(queries.size());
+	forEachQuery(queries.size(), [&queries, &paths](AStar& astar, size_t i) {
+		paths[i] = astar.Pathfind(queries[i].start, queries[i].destination);
+	});
+}
@@ -0,0 +1,62 @@
+/**
+ * @file BatchPathfinder.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the BatchPathfinder class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "AStar.h"
+
+#include <vector>
+#include <functional>
+
+/**
+ * @brief A start and destination pair, only y and x of the nodes are used.
+ */
+struct PathQuery {
+	Node start, destination;
+};
+
+/**
+ * @brief The answer to a PathQuery when only the first step is needed.
+ */
+struct PathResult {
+	int		length;		//nodes on the path including the start, 0 if there is no path
+	Node	next;		//the node following the start, only set if length >= 2
+	int		expansions;	//nodes popped by the search
+};
+
+/**
+ * @class BatchPathfinder
+ * @brief 	Runs many pathfinding queries at once, spread over several threads. A single
+ * 			AStar is not reentrant since its scratch buffers are members, so every thread
+ * 			gets an AStar of its own, kept between batches so the scratch is only made once.
+ * 			The map is only read, it must not change during a batch. The threads take small
+ * 			chunks of queries from a shared counter, so a few long queries do not leave the
+ * 			other threads idle. The results are always in the same order as the queries.
+ */
+class BatchPathfinder
+{
+public:
+	BatchPathfinder(MazeGrid map, SearchMode mode = SearchMode::Standard,
+					unsigned int threadCount = 0);
+	~BatchPathfinder();
+
+	void FindPaths(const std::vector<PathQuery>& queries, std::vector<PathResult>& results);
+	void FindPaths(const std::vector<PathQuery>& queries, std::vector<std::vector<Node>>& paths);
+
+	void setThreadCount(unsigned int threadCount);
+	inline unsigned int getThreadCount() const { return threads; }
+
+private:
+	MazeGrid m_map;
+	SearchMode m_mode;
+	unsigned int threads;
+	std::vector<AStar*> searchers;	//one per thread, made the first time the thread is used
+
+	void forEachQuery(size_t count, const std::function<void(AStar&, size_t)>& work);
+};
@@ -49,36 +49,6 @@ public:
     float MouseSensitivity;
     float Zoom;
     
-    void constrainMovement(glm::vec3 m_OldPos,std::vector<std::vector<int>> m_Map2d)
-    {
-        //Constrains movement
-        if (Position.z != m_OldPos.z)
-            if (Position.z - m_OldPos.z < 0.0f) {
-                if (m_Map2d[floor(Position.z - 0.1f)][floor(Position.x)] == 1)
-                    Position.z = m_OldPos.z;
-            }
-            else if (Position.z - m_OldPos.z > 0.0f) {
-                if (m_Map2d[floor(Position.z + 0.1f)][floor(Position.x)] == 1)
-                    Position.z = m_OldPos.z;
-            }
-        if (Position.x != m_OldPos.x)
-            if (Position.x - m_OldPos.x < 0.0f) {
-                if (m_Map2d[floor(Position.z)][floor(Position.x - 0.1f)] == 1)
-                    Position.x = m_OldPos.x;
-            }
-            else if (Position.x - m_OldPos.x > 0.0f) {
-                if (m_Map2d[floor(Position.z)][floor(Position.x + 0.1f)] == 1)
-                    Position.x = m_OldPos.x;
-            }
-        Position.y = 0.5f;
-
-        //"Teleport" the player if they use the "tunnel"
-        if (Position.x <= 0.3f)
-            Position.x = m_Map2d[0].size()-1.f;
-        if (Position.x >= m_Map2d[0].size()-0.3f)
-            Position.x = 1.f;
-    }
-
     // constructor with vectors
     Camera(glm::vec3 position = glm::vec3(0.0f, 0.35f, 3.0f), glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f), float yaw = YAW, float pitch = PITCH) : Front(glm::vec3(0.0f, 0.0f, -1.0f)), MovementSpeed(SPEED), MouseSensitivity(SENSITIVITY), Zoom(ZOOM)
     {
@@ -105,21 +75,18 @@ public:
     }
 
     // processes input received from any keyboard-like input system. Accepts input parameter in the form of camera defined ENUM (to abstract it from windowing systems)
-    void ProcessKeyboard(Camera_Movement direction, float deltaTime, std::vector<std::vector<int>> m_Map2d, bool m_ConstrainMovement)
+    // returns the world space direction the player wants to move in, the actual movement is done by the GameSim
+    glm::vec3 ProcessKeyboard(Camera_Movement direction)
     {
-        glm::vec3 oldPos = Position;
-        float velocity = MovementSpeed * deltaTime;
-        
         switch (direction)
         {
-        case FORWARD:   Position += Front * velocity;   break;
-        case BACKWARD:  Position -= Front * velocity;   break;
-        case LEFT:      Position -= Right * velocity;   break;
-        case RIGHT:     Position += Right * velocity;   break;
+        case FORWARD:   return Front;
+        case BACKWARD:  return -Front;
+        case LEFT:      return -Right;
+        case RIGHT:     return Right;
         default: break;
         }
-        if (m_ConstrainMovement)
-            constrainMovement(oldPos, m_Map2d);
+        return glm::vec3(0.0f);
     }
 
     // processes input received from a mouse input system. Expects the offset value in both the x and y direction.
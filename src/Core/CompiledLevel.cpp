@@ -0,0 +1,148 @@
+/**
+ * @file CompiledLevel.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class for reading and writing levels compiled by levelc.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "CompiledLevel.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace {
+	const uint32_t VERSION = 5;				//bumped every time the layout of a section changes
+	const uint64_t SECTION_ALIGNMENT = 16;	//every section starts at a multiple of this
+
+	/**
+	 * @brief The header at the start of the file.
+	 */
+	struct FileHeader {
+		char		magic[4];	//"PMLC"
+		uint32_t	version,
+					width,
+					height,
+					sectionCount,
+					reserved;
+	};
+
+	/**
+	 * @brief One entry of the section table following the header.
+	 */
+	struct SectionEntry {
+		uint32_t	type,
+					elementSize;
+		uint64_t	offset,		//from the start of the file
+					bytes;
+	};
+
+	inline uint64_t align(uint64_t offset) { return (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT; }
+}
+
+/**
+ * @brief 	Construct a new CompiledLevel::CompiledLevel object, mapping the file and checking
+ * 			that the header and every section fit in it.
+ *
+ * @param filepath - The compiled level, isLoaded() is false if it is missing or broken
+ */
+CompiledLevel::CompiledLevel(const std::string& filepath)
+	:	file(new MappedFile(filepath)),
+		loaded(false),
+		width(0),
+		height(0),
+		sectionCount(0),
+		sections(nullptr)
+{
+	const char* data = file->getData();
+	size_t size = file->getSize();
+	if (data == nullptr || size < sizeof(FileHeader))
+		return;
+
+	FileHeader header;
+	std::memcpy(&header, data, sizeof(header));
+	if (std::memcmp(header.magic, "PMLC", 4) != 0 || header.version != VERSION ||
+		(size - sizeof(FileHeader)) / sizeof(SectionEntry) < header.sectionCount)
+		return;
+
+	const SectionEntry* entries = (const SectionEntry*)(data + sizeof(FileHeader));
+	for (uint32_t i = 0; i < header.sectionCount; i++)
+		if (entries[i].offset > size || entries[i].bytes > size - entries[i].offset || entries[i].elementSize == 0)
+			return;
+
+	width = header.width;
+	height = header.height;
+	sectionCount = header.sectionCount;
+	sections = entries;
+	loaded = true;
+}
+
+/**
+ * @brief Destroy the CompiledLevel::CompiledLevel object, unmapping the file.
+ *
+ */
+CompiledLevel::~CompiledLevel()
+{
+	delete file;
+}
+
+/**
+ * @brief Finds a section in the file.
+ *
+ * @param type 			- The section
+ * @param elementSize 	- The size of one element, has to match the size it was saved with
+ * @param count 		- Set to the amount of elements, 0 if the section is missing
+ * @return const void* 	- The first element, nullptr if the section is missing or the size differs
+ */
+const void* CompiledLevel::getSection(LevelSection type, size_t elementSize, size_t& count) const
+{
+	count = 0;
+	const SectionEntry* entries = (const SectionEntry*)sections;
+	for (uint32_t i = 0; i < sectionCount; i++)
+		if (entries[i].type == (uint32_t)type) {
+			if (entries[i].elementSize != elementSize)
+				return nullptr;
+			count = entries[i].bytes / elementSize;
+			return file->getData() + entries[i].offset;
+		}
+	return nullptr;
+}
+
+/**
+ * @brief 	Writes a compiled level: the header, the section table and then every section,
+ * 			each aligned to 16 bytes so it can be used in place once mapped.
+ *
+ * @param filepath 	- Where to write the file
+ * @param width 	- The width of the level
+ * @param height 	- The height of the level
+ * @param sections 	- The sections to write
+ * @return true 	- The file was written
+ */
+bool CompiledLevel::save(const std::string& filepath, int width, int height, const std::vector<Section>& sections)
+{
+	std::ofstream out(filepath, std::ios::binary);
+	if (!out)
+		return false;
+
+	FileHeader header = { { 'P', 'M', 'L', 'C' }, VERSION, (uint32_t)width, (uint32_t)height, (uint32_t)sections.size(), 0 };
+	std::vector<SectionEntry> entries;
+	uint64_t offset = align(sizeof(FileHeader) + sizeof(SectionEntry) * sections.size());
+	for (const auto& section : sections) {
+		uint64_t bytes = (uint64_t)section.elementSize * section.count;
+		entries.push_back({ (uint32_t)section.type, section.elementSize, offset, bytes });
+		offset = align(offset + bytes);
+	}
+
+	out.write((const char*)&header, sizeof(header));
+	out.write((const char*)entries.data(), sizeof(SectionEntry) * entries.size());
+	uint64_t written = sizeof(FileHeader) + sizeof(SectionEntry) * entries.size();
+	const char padding[SECTION_ALIGNMENT] = {};
+	for (size_t i = 0; i < sections.size(); i++) {
+		out.write(padding, entries[i].offset - written);
+		out.write((const char*)sections[i].data, entries[i].bytes);
+		written = entries[i].offset + entries[i].bytes;
+	}
+	return (bool)out;
+}
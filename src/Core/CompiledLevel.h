@@ -0,0 +1,108 @@
+/**
+ * @file CompiledLevel.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the CompiledLevel class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "MappedFile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 	The kinds of data a compiled level can hold, every one at most once. 6 and 8 held
+ * 			the minimap positions and the pellet matrices up to version 4, both are made at
+ * 			load time now.
+ *
+ */
+enum class LevelSection : uint32_t {
+	Tiles			 = 1,	//uint8_t per tile, row after row
+	Spawns			 = 2,	//LevelSpawn for the player and every ghost ID in the level
+	Pellets			 = 3,	//LevelTile for every pellet, in the order GameSim places them
+	MazeVertices	 = 4,	//Vertex, the walls of Maze3D, not written for streamed levels
+	MazeIndices		 = 5,	//unsigned int
+	MinimapIndices	 = 7,	//unsigned int, the walls of Maze, not written for streamed levels
+	NextHopTable	 = 9,	//a table as written by NextHopTable::serialize
+	MazeChunks		 = 10	//MeshChunk, the ranges of MazeIndices culled by Maze3D
+};
+
+/**
+ * @brief A tile of the level.
+ *
+ */
+struct LevelTile {
+	int32_t x,
+			y;
+};
+
+/**
+ * @brief Where an ID of the level file is placed, 2 is the player and 3 and up the ghosts.
+ *
+ */
+struct LevelSpawn {
+	int32_t id,
+			x,
+			y;
+};
+
+/**
+ * @class CompiledLevel
+ * @brief 	A level with everything derived from it precomputed by levelc: the tiles, the
+ * 			spawns, the pellets, the meshes of both mazes and the next hop table. The file
+ * 			is memory mapped and the sections are used in place, nothing is parsed. It is a
+ * 			build artifact for the machine it was built on (the structs are stored as they
+ * 			are in memory), the version and the size of every element are checked on load.
+ */
+class CompiledLevel
+{
+public:
+	/**
+	 * @brief A section to be written by save().
+	 *
+	 */
+	struct Section {
+		LevelSection type;
+		uint32_t elementSize;
+		const void* data;
+		size_t count;
+	};
+
+	CompiledLevel(const std::string& filepath);
+	~CompiledLevel();
+
+	static bool save(const std::string& filepath, int width, int height, const std::vector<Section>& sections);
+	static std::string pathFor(const std::string& levelPath) { return levelPath + ".lvlc"; }
+
+	const void* getSection(LevelSection type, size_t elementSize, size_t& count) const;
+
+	/**
+	 * @brief Returns a section as an array of T.
+	 *
+	 * @param type 		- The section
+	 * @param count 	- Set to the amount of elements, 0 if the section is missing
+	 * @return const T* - The first element, nullptr if the section is missing or was stored with another size of T
+	 */
+	template <typename T>
+	const T* getSection(LevelSection type, size_t& count) const
+	{
+		return (const T*)getSection(type, sizeof(T), count);
+	}
+
+	inline bool isLoaded() const { return loaded; }
+	inline int getWidth()  const { return width; }
+	inline int getHeight() const { return height; }
+
+private:
+	MappedFile* file;
+	bool loaded;
+	int width, height;
+	uint32_t sectionCount;
+	const void* sections;	//the section table, right after the header
+};
@@ -0,0 +1,413 @@
+/**
+ * @file DStarLite.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class for incrementally repairing the path of a ghost as the level changes.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "DStarLite.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+	const int offsetY[4] = { -1, 1, 0, 0 }; //same order as FlowStep
+	const int offsetX[4] = { 0, 0, -1, 1 };
+	const int INF = DStarLite::WALL;		//g and rhs of cells that can not reach the goal
+}
+
+/**
+ * @brief Construct a new DStarLite::DStarLite object. Nothing is planned until reset is called.
+ *
+ * @param map 				- The 2d grid of the maze
+ * @param wrapHorizontal 	- Wheter or not walking off the left/right edge enters on the other side
+ */
+DStarLite::DStarLite(MazeGrid map, bool wrapHorizontal)
+	:	height(map.getHeight()),
+		width(map.getWidth()),
+		wrap(wrapHorizontal),
+		start(-1),
+		goal(-1),
+		km(0),
+		lastExpansions(0),
+		fullPlanExpansions(0),
+		updates(0),
+		totalExpansions(0),
+		repairPending(false)
+{
+	cost.resize(height * width);
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			cost[y * width + x] = map(y, x) == 1 ? WALL : 1;
+
+	g.assign(height * width, INF);
+	rhs.assign(height * width, INF);
+	queueIndex.assign(height * width, -1);
+	queue.reserve(height * width);
+}
+
+/**
+ * @brief Finds the neighbour of a cell in a given direction.
+ *
+ * @param cell 		- y * width + x of the cell
+ * @param direction - FlowStep to take
+ * @return int 		- y * width + x of the neighbour, -1 if it is outside the map
+ */
+int DStarLite::neighbour(int cell, int direction) const
+{
+	int y = cell / width + offsetY[direction];
+	int x = cell % width + offsetX[direction];
+	if (wrap)	//the tunnel
+		x = (x + width) % width;
+	if (y < 0 || y >= height || x < 0 || x >= width)
+		return -1;
+	return y * width + x;
+}
+
+/**
+ * @brief Manhattan distance between two cells, taking the tunnel into account.
+ *
+ * @param from 	- y * width + x of the first cell
+ * @param to 	- y * width + x of the second cell
+ * @return int
+ */
+int DStarLite::heuristic(int from, int to) const
+{
+	int dy = abs(from / width - to / width);
+	int dx = abs(from % width - to % width);
+	if (wrap)
+		dx = std::min(dx, width - dx);
+	return dy + dx;
+}
+
+/**
+ * @brief The priority of a cell, cells closer to being on the path of the start come first.
+ *
+ * @param cell 	- y * width + x of the cell
+ * @return Key
+ */
+DStarLite::Key DStarLite::calculateKey(int cell) const
+{
+	int m = std::min(g[cell], rhs[cell]);
+	return { m + heuristic(start, cell) + km, m };
+}
+
+/**
+ * @brief The cost of the best step from a cell, entering a neighbour and going on from there.
+ *
+ * @param cell 	- y * width + x of the cell
+ * @return int 	- The lowest cost over all neighbours, INF if there is none
+ */
+int DStarLite::lookahead(int cell) const
+{
+	if (cost[cell] >= WALL)
+		return INF;
+	int best = INF;
+	for (int d = 0; d < 4; d++) {
+		int n = neighbour(cell, d);
+		if (n == -1 || cost[n] >= WALL || g[n] >= INF)
+			continue;
+		best = std::min(best, cost[n] + g[n]);
+	}
+	return best;
+}
+
+/**
+ * @brief Recalculates the lookahead of a cell, and queues it if it became inconsistent.
+ *
+ * @param cell - y * width + x of the cell
+ */
+void DStarLite::updateVertex(int cell)
+{
+	if (cell != goal)
+		rhs[cell] = lookahead(cell);
+	if (queueIndex[cell] != -1)
+		queueRemove(cell);
+	if (g[cell] != rhs[cell])
+		queueInsert(cell, calculateKey(cell));
+}
+
+/**
+ * @brief 	Expands inconsistent cells until the start is consistent and nothing left in the
+ * 			queue could give it a shorter path. Counts the cells expanded.
+ *
+ */
+void DStarLite::computeShortestPath()
+{
+	lastExpansions = 0;
+	while (!queue.empty() && (queue[0].key < calculateKey(start) || rhs[start] != g[start])) {
+		Key oldKey = queue[0].key;
+		int cell = queue[0].cell;
+		Key newKey = calculateKey(cell);
+		lastExpansions++;
+
+		if (oldKey < newKey) {	//the start has moved since it was queued
+			queueRemove(cell);
+			queueInsert(cell, newKey);
+		}
+		else if (g[cell] > rhs[cell]) {	//overconsistent, the cell got cheaper
+			g[cell] = rhs[cell];
+			queueRemove(cell);
+			for (int d = 0; d < 4; d++) {
+				int n = neighbour(cell, d);
+				if (n != -1)
+					updateVertex(n);
+			}
+		}
+		else {	//underconsistent, the cell got more expensive
+			g[cell] = INF;
+			updateVertex(cell);
+			for (int d = 0; d < 4; d++) {
+				int n = neighbour(cell, d);
+				if (n != -1)
+					updateVertex(n);
+			}
+		}
+	}
+	totalExpansions += lastExpansions;
+	repairPending = false;
+}
+
+/**
+ * @brief Throws away the search and plans again from scratch.
+ *
+ * @param startY 	- The y coordinate of the ghost
+ * @param startX 	- The x coordinate of the ghost
+ * @param goalY 	- The y coordinate of the goal (the player's tile)
+ * @param goalX 	- The x coordinate of the goal (the player's tile)
+ */
+void DStarLite::reset(int startY, int startX, int goalY, int goalX)
+{
+	for (const auto& entry : queue)
+		queueIndex[entry.cell] = -1;
+	queue.clear();
+	std::fill(g.begin(), g.end(), INF);
+	std::fill(rhs.begin(), rhs.end(), INF);
+
+	start = startY * width + startX;
+	goal = goalY * width + goalX;
+	km = 0;
+	updates = 0;
+	rhs[goal] = 0;
+	queueInsert(goal, calculateKey(goal));
+
+	computeShortestPath();
+	fullPlanExpansions = lastExpansions;
+}
+
+/**
+ * @brief 	The ghost has moved. Instead of reordering the queue the distance moved is
+ * 			added to km, which is added to the keys of everything queued from now on.
+ *
+ * @param y - The new y coordinate of the ghost
+ * @param x - The new x coordinate of the ghost
+ */
+void DStarLite::moveStart(int y, int x)
+{
+	int cell = y * width + x;
+	if (cell == start)
+		return;
+	km += heuristic(start, cell);
+	start = cell;
+	repairPending = true;
+}
+
+/**
+ * @brief 	The goal has moved. The old goal gets its lookahead back, the new one gets
+ * 			a distance of 0, and the change spreads from there on the next query.
+ *
+ * @param y - The y coordinate of the new goal
+ * @param x - The x coordinate of the new goal
+ */
+void DStarLite::moveGoal(int y, int x)
+{
+	int cell = y * width + x;
+	if (cell == goal)
+		return;
+	int oldGoal = goal;
+	goal = cell;
+	rhs[goal] = 0;
+	updateVertex(oldGoal);
+	updateVertex(goal);
+	repairPending = true;
+}
+
+/**
+ * @brief Changes the cost of entering a cell, WALL makes it impassable.
+ *
+ * @param y 	- The y coordinate of the cell
+ * @param x 	- The x coordinate of the cell
+ * @param newCost - The new cost, at least 1 so the heuristic stays admissible
+ */
+void DStarLite::setCost(int y, int x, int newCost)
+{
+	int cell = y * width + x;
+	newCost = std::max(1, std::min(newCost, (int)WALL));
+	if (cost[cell] == newCost)
+		return;
+	cost[cell] = newCost;
+
+	//Every step into the cell changed cost, and so did the cell itself if it became a wall
+	updateVertex(cell);
+	for (int d = 0; d < 4; d++) {
+		int n = neighbour(cell, d);
+		if (n != -1)
+			updateVertex(n);
+	}
+	repairPending = true;
+}
+
+/**
+ * @brief Repairs the search if anything changed, then looks up the first step from the ghost.
+ *
+ * @param step 		- Is set to the step towards the goal
+ * @return true 	- There is a next step
+ * @return false 	- Not initialised, already at the goal, or the goal can not be reached
+ */
+bool DStarLite::NextStep(FlowStep& step)
+{
+	step = StepNone;
+	if (start == -1 || start == goal)
+		return false;
+	if (repairPending) {
+		computeShortestPath();
+		updates++;
+	}
+	if (g[start] >= INF && rhs[start] >= INF)
+		return false;
+
+	int best = INF;
+	for (int d = 0; d < 4; d++) {
+		int n = neighbour(start, d);
+		if (n == -1 || cost[n] >= WALL || g[n] >= INF)
+			continue;
+		if (cost[n] + g[n] < best) {
+			best = cost[n] + g[n];
+			step = (FlowStep)d;
+		}
+	}
+	return step != StepNone;
+}
+
+/**
+ * @brief 	Follows the search from the ghost for a number of steps, taking the cheapest
+ * 			neighbour every time. Call NextStep first so the search is up to date.
+ *
+ * @param steps 	- Is filled with the steps, it stops early at the goal
+ * @param maxSteps 	- The most steps to follow
+ * @return int 		- The amount of steps found
+ */
+int DStarLite::GetPath(std::vector<FlowStep>& steps, int maxSteps) const
+{
+	steps.clear();
+	if (start == -1 || (g[start] >= INF && rhs[start] >= INF))
+		return 0;
+
+	int cell = start;
+	while (cell != goal && (int)steps.size() < maxSteps) {
+		int best = INF, next = -1;
+		FlowStep step = StepNone;
+		for (int d = 0; d < 4; d++) {
+			int n = neighbour(cell, d);
+			if (n == -1 || cost[n] >= WALL || g[n] >= INF)
+				continue;
+			if (cost[n] + g[n] < best) {
+				best = cost[n] + g[n];
+				next = n;
+				step = (FlowStep)d;
+			}
+		}
+		if (next == -1)
+			break;
+		steps.push_back(step);
+		cell = next;
+	}
+	return steps.size();
+}
+
+/**
+ * @brief Adds a cell to the queue.
+ *
+ * @param cell 	- y * width + x of the cell
+ * @param key 	- Its priority
+ */
+void DStarLite::queueInsert(int cell, Key key)
+{
+	queue.push_back({ key, cell });
+	queueIndex[cell] = queue.size() - 1;
+	queueSiftUp(queue.size() - 1);
+}
+
+/**
+ * @brief Removes a cell from the queue, wherever it is in the heap.
+ *
+ * @param cell - y * width + x of the cell
+ */
+void DStarLite::queueRemove(int cell)
+{
+	int position = queueIndex[cell];
+	int last = queue.size() - 1;
+	if (position != last) {
+		queueSwap(position, last);
+		queue.pop_back();
+		queueSiftDown(position);
+		queueSiftUp(position);
+	}
+	else
+		queue.pop_back();
+	queueIndex[cell] = -1;
+}
+
+/**
+ * @brief Moves an entry up the heap until its parent has a lower key.
+ *
+ * @param position - Index of the entry in the queue
+ */
+void DStarLite::queueSiftUp(int position)
+{
+	while (position > 0) {
+		int parent = (position - 1) / 2;
+		if (!(queue[position].key < queue[parent].key))
+			break;
+		queueSwap(position, parent);
+		position = parent;
+	}
+}
+
+/**
+ * @brief Moves an entry down the heap until both children have a higher key.
+ *
+ * @param position - Index of the entry in the queue
+ */
+void DStarLite::queueSiftDown(int position)
+{
+	int size = queue.size();
+	while (true) {
+		int smallest = position;
+		int left = position * 2 + 1, right = left + 1;
+		if (left < size && queue[left].key < queue[smallest].key)
+			smallest = left;
+		if (right < size && queue[right].key < queue[smallest].key)
+			smallest = right;
+		if (smallest == position)
+			break;
+		queueSwap(position, smallest);
+		position = smallest;
+	}
+}
+
+/**
+ * @brief Swaps two entries of the heap and keeps queueIndex up to date.
+ *
+ * @param a - Index of the first entry
+ * @param b - Index of the second entry
+ */
+void DStarLite::queueSwap(int a, int b)
+{
+	std::swap(queue[a], queue[b]);
+	queueIndex[queue[a].cell] = a;
+	queueIndex[queue[b].cell] = b;
+}
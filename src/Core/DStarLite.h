@@ -0,0 +1,91 @@
+/**
+ * @file DStarLite.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the DStarLite class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "FlowField.h"
+
+#include <vector>
+#include <climits>
+
+/**
+ * @class DStarLite
+ * @brief 	Incremental planner (D* Lite) for a single ghost. The search runs backwards from
+ * 			the goal and is kept between queries, so when the ghost moves, the goal moves or
+ * 			the cost of a cell changes only the part of the search that is affected is
+ * 			repaired instead of planning again from scratch. Entering a cell costs the cost
+ * 			of that cell, 1 unless changed with setCost.
+ */
+class DStarLite
+{
+public:
+	static constexpr int WALL = INT_MAX / 4;	//cost of a cell that can not be entered
+
+	DStarLite(MazeGrid map, bool wrapHorizontal = true);
+
+	void reset(int startY, int startX, int goalY, int goalX);
+	void moveStart(int y, int x);
+	void moveGoal(int y, int x);
+	void setCost(int y, int x, int cost);
+	bool NextStep(FlowStep& step);
+	int  GetPath(std::vector<FlowStep>& steps, int maxSteps) const;
+
+	inline bool isInitialised()				const { return start != -1; }
+	inline int  getStartY()					const { return start / width; }
+	inline int  getStartX()					const { return start % width; }
+	inline int  getGoalY()					const { return goal / width; }
+	inline int  getGoalX()					const { return goal % width; }
+	inline int  getLastExpansions()			const { return lastExpansions; }	//expanded by the last repair
+	inline int  getFullPlanExpansions()		const { return fullPlanExpansions; }	//expanded by the last plan from scratch
+	inline long long getTotalExpansions()	const { return totalExpansions; }
+	inline int  getUpdates()				const { return updates; }	//repairs since the last plan from scratch
+
+private:
+	int height, width;
+	bool wrap;
+	int start, goal;	//y * width + x, the search runs from the goal towards the start
+	int km;				//how far the start has moved, added to the keys instead of reordering the queue
+
+	int lastExpansions, fullPlanExpansions, updates;
+	long long totalExpansions;
+	bool repairPending;		//something changed since the last search
+
+	std::vector<int> cost;	//cost of entering every cell
+	std::vector<int> g;		//current estimate of the distance to the goal
+	std::vector<int> rhs;	//one step lookahead of g, the cell is consistent when they are equal
+
+	/**
+	 * @brief The priority of a cell in the queue, compared first on k1 and then on k2.
+	 */
+	struct Key {
+		int k1, k2;
+		bool operator<(const Key& other) const { return k1 < other.k1 || (k1 == other.k1 && k2 < other.k2); }
+	};
+
+	//Indexed binary heap, so cells can be updated and removed in place
+	struct QueueEntry {
+		Key key;
+		int cell;
+	};
+	std::vector<QueueEntry> queue;
+	std::vector<int> queueIndex;	//y * width + x -> position in queue, -1 if not queued
+
+	int  neighbour(int cell, int direction) const;
+	int  heuristic(int from, int to) const;
+	Key  calculateKey(int cell) const;
+	int  lookahead(int cell) const;
+	void updateVertex(int cell);
+	void computeShortestPath();
+
+	void queueInsert(int cell, Key key);
+	void queueRemove(int cell);
+	void queueSiftUp(int position);
+	void queueSiftDown(int position);
+	void queueSwap(int a, int b);
+};
@@ -0,0 +1,57 @@
+/**
+ * @file EmbeddedAssets.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Lookup of the levels and shaders embedded into the executable.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "EmbeddedAssets.h"
+
+#include <cstring>
+
+#ifdef EMBED_ASSETS
+#include "LevelText.h"
+
+//Generated by cmake/EmbedAssets.cmake from the levels and shaders folders: embeddedFiles and embeddedLevels,
+//both ending with an entry without a path
+#include "EmbeddedAssetData.inc"
+#endif
+
+/**
+ * @brief Finds an embedded file.
+ *
+ * @param path 					- The path the file is loaded with
+ * @return const EmbeddedFile* 	- The file, nullptr if it is not embedded
+ */
+const EmbeddedFile* findEmbeddedFile(const char* path)
+{
+#ifdef EMBED_ASSETS
+	for (const EmbeddedFile* file = embeddedFiles; file->path != nullptr; file++)
+		if (std::strcmp(file->path, path) == 0)
+			return file;
+#else
+	(void)path;
+#endif
+	return nullptr;
+}
+
+/**
+ * @brief Finds an embedded level.
+ *
+ * @param path 					- The path the level is loaded with
+ * @return const EmbeddedLevel* - The level, nullptr if it is not embedded
+ */
+const EmbeddedLevel* findEmbeddedLevel(const char* path)
+{
+#ifdef EMBED_ASSETS
+	for (const EmbeddedLevel* level = embeddedLevels; level->path != nullptr; level++)
+		if (std::strcmp(level->path, path) == 0)
+			return level;
+#else
+	(void)path;
+#endif
+	return nullptr;
+}
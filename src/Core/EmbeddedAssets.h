@@ -0,0 +1,38 @@
+/**
+ * @file EmbeddedAssets.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Lookup of the levels and shaders embedded into the executable.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief A file embedded into the executable, null terminated.
+ *
+ */
+struct EmbeddedFile {
+	const char* path;	//the path it is loaded with, e.g. "shaders/maze.vs"
+	const char* data;
+	size_t size;
+};
+
+/**
+ * @brief A level embedded into the executable, already parsed and checked by the compiler.
+ *
+ */
+struct EmbeddedLevel {
+	const char* path;	//the path it is loaded with, e.g. "levels/level0"
+	const uint8_t* tiles;
+	int width,
+		height;
+};
+
+//Both return nullptr for anything not embedded, and always when the game is built without EMBED_ASSETS
+const EmbeddedFile* findEmbeddedFile(const char* path);
+const EmbeddedLevel* findEmbeddedLevel(const char* path);
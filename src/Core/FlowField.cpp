@@ -0,0 +1,111 @@
+/**
+ * @file FlowField.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class for calculating the next step towards a single goal for every cell.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "FlowField.h"
+#include <algorithm>
+
+/**
+ * @brief Construct a new FlowField::FlowField object
+ *
+ * @param map 				- The 2d grid of the maze
+ * @param wrapHorizontal 	- Wheter or not walking off the left/right edge enters on the other side
+ */
+FlowField::FlowField(MazeGrid map, bool wrapHorizontal)
+	:	m_map(map),
+		height(map.getHeight()),
+		width(map.getWidth()),
+		goalY(-1),
+		goalX(-1),
+		wrap(wrapHorizontal),
+		board(map, wrapHorizontal)
+{
+	distance.assign(height * width, -1);
+	flow.assign(height * width, StepNone);
+}
+
+/**
+ * @brief Checks wheter or not any given cell can be walked on.
+ *
+ * @param y - The y coordinate of the cell
+ * @param x - The x coordinate of the cell
+ * @return true - The cell is inside the map and is not a wall
+ */
+bool FlowField::isValid(int y, int x) const
+{
+	if (y < 0 || y >= height || x < 0 || x >= width)
+		return false;
+	return (m_map(y, x) != 1);
+}
+
+/**
+ * @brief 	Runs a breadth first search outwards from the goal, then every reached cell
+ * 			stores the step to a neighbour that is one step closer to the goal.
+ * 			Does not allocate any memory.
+ *
+ * @param y - The y coordinate of the goal (the player's tile)
+ * @param x - The x coordinate of the goal (the player's tile)
+ */
+void FlowField::build(int y, int x)
+{
+	goalY = y;
+	goalX = x;
+	std::fill(flow.begin(), flow.end(), (unsigned char)StepNone);
+	board.distanceField(y, x, distance);	//all -1 if the goal is a wall
+
+	//The offsets to the neighbours, in FlowStep order
+	const int offsetY[4] = { -1, 1, 0, 0 };
+	const int offsetX[4] = { 0, 0, -1, 1 };
+
+	for (int cy = 0; cy < height; cy++)
+		for (int cx = 0; cx < width; cx++) {
+			int steps = distance[cy * width + cx];
+			if (steps <= 0)
+				continue;
+			for (int i = 0; i < 4; i++) {
+				int ny = cy + offsetY[i];
+				int nx = cx + offsetX[i];
+				if (wrap)	//the tunnel
+					nx = (nx + width) % width;
+				if (isValid(ny, nx) && distance[ny * width + nx] == steps - 1) {
+					flow[cy * width + cx] = i;
+					break;
+				}
+			}
+		}
+}
+
+/**
+ * @brief Looks up the next cell on the shortest path from a cell to the goal.
+ *
+ * @param y 		- The y coordinate of the cell
+ * @param x 		- The x coordinate of the cell
+ * @param nextY 	- Is set to the y coordinate of the next cell
+ * @param nextX 	- Is set to the x coordinate of the next cell, wrapped through the tunnel
+ * @return true 	- There is a next step
+ * @return false 	- The cell is the goal, a wall or can not reach the goal
+ */
+bool FlowField::NextStep(int y, int x, int& nextY, int& nextX) const
+{
+	if (y < 0 || y >= height || x < 0 || x >= width)
+		return false;
+
+	nextY = y; nextX = x;
+	switch (getStep(y, x))
+	{
+	case StepUp:	nextY--; break;
+	case StepDown:	nextY++; break;
+	case StepLeft:	nextX--; break;
+	case StepRight:	nextX++; break;
+	default:		return false;
+	}
+	if (wrap)
+		nextX = (nextX + width) % width;
+	return true;
+}
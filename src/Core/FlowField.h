@@ -0,0 +1,60 @@
+/**
+ * @file FlowField.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the FlowField class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "GridBitboard.h"
+
+#include <vector>
+
+/**
+ * @brief 	The step stored in every cell of the flow field, the values match the
+ * 			order of the Direction enum used by the game (North, South, East, West).
+ */
+enum FlowStep : unsigned char {
+	StepUp		= 0,	// y - 1
+	StepDown	= 1,	// y + 1
+	StepLeft	= 2,	// x - 1
+	StepRight	= 3,	// x + 1
+	StepNone	= 255	// the goal itself, a wall or unreachable
+};
+
+/**
+ * @class FlowField
+ * @brief 	A breadth first search rooted at a single goal (the player), storing the
+ * 			next step towards the goal for every cell in the grid. Built once per tick
+ * 			and shared by all ghosts, which then read their move in O(1). The distances
+ * 			come from a bit-parallel search over a GridBitboard of the level.
+ */
+class FlowField
+{
+public:
+	FlowField(MazeGrid map, bool wrapHorizontal = true);
+
+	void build(int goalY, int goalX);
+
+	inline FlowStep getStep(int y, int x) const { return (FlowStep)flow[y * width + x]; }
+	inline int getDistance(int y, int x) const { return distance[y * width + x]; }
+	inline int getGoalY() const { return goalY; }
+	inline int getGoalX() const { return goalX; }
+	bool NextStep(int y, int x, int& nextY, int& nextX) const;
+
+private:
+	MazeGrid m_map;
+
+	int height, width;
+	int goalY, goalX;
+	bool wrap;	//cells on the left and right edge are neighbours, used by the tunnel
+
+	GridBitboard				board;
+	std::vector<int>			distance;	//steps to the goal, -1 if unreachable
+	std::vector<unsigned char>	flow;		//FlowStep towards the goal
+
+	bool isValid(int y, int x) const;
+};
@@ -0,0 +1,59 @@
+/**
+ * @file Frustum.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief The view frustum of a camera, for skipping what it cannot see
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <glm/glm.hpp>
+
+/**
+ * @class Frustum
+ * @brief 	The six planes bounding what a projection and view matrix can see, taken straight
+ * 			out of their product. Everything tested against it has to be in world space.
+ */
+class Frustum
+{
+public:
+	/**
+	 * @brief Construct a new Frustum object
+	 *
+	 * @param projection 	- The projection matrix
+	 * @param view 			- The view matrix
+	 */
+	Frustum(const glm::mat4& projection, const glm::mat4& view)
+	{
+		//glm is column major, row i of the matrix is m[0][i], m[1][i], m[2][i], m[3][i]
+		glm::mat4 m = projection * view;
+		for (int i = 0; i < 3; i++) {
+			planes[i * 2] = glm::vec4(m[0][3] + m[0][i], m[1][3] + m[1][i], m[2][3] + m[2][i], m[3][3] + m[3][i]);
+			planes[i * 2 + 1] = glm::vec4(m[0][3] - m[0][i], m[1][3] - m[1][i], m[2][3] - m[2][i], m[3][3] - m[3][i]);
+		}
+	}
+
+	/**
+	 * @brief 	Tests a box against the frustum. Boxes near a corner of it may pass without
+	 * 			being seen, a box that is seen never fails.
+	 *
+	 * @param min - The corner of the box with the smallest coordinates
+	 * @param max - The corner of the box with the largest coordinates
+	 * @return false - The box is completely outside
+	 */
+	bool intersects(const glm::vec3& min, const glm::vec3& max) const
+	{
+		for (const auto& plane : planes) {
+			//The corner furthest along the normal, if it is behind the plane the whole box is
+			glm::vec3 corner(plane.x >= 0 ? max.x : min.x, plane.y >= 0 ? max.y : min.y, plane.z >= 0 ? max.z : min.z);
+			if (glm::dot(glm::vec3(plane), corner) + plane.w < 0)
+				return false;
+		}
+		return true;
+	}
+
+private:
+	glm::vec4 planes[6];	//left, right, bottom, top, near, far; the normals point inwards
+};
@@ -0,0 +1,229 @@
+/**
+ * @file GpuDistanceField.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class for computing the distance field towards the player with compute shaders.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "GpuDistanceField.h"
+
+#include <algorithm>
+
+namespace {
+	const int UNREACHED = 0x3fffffff;	//same as in the shaders
+	const int GROUP_SIZE = 16;			//local size of distance.comp
+	const int ROUTE_GROUP_SIZE = 64;	//local size of route.comp
+	const int PASSES_PER_CHECK = 4;		//passes dispatched between reading back wheter anything changed
+}
+
+/**
+ * @brief Construct a new GpuDistanceField::GpuDistanceField object, uploading the walls.
+ *
+ * @param map 				- The 2d grid of the maze
+ * @param wrapHorizontal 	- Wheter or not walking off the left/right edge enters on the other side
+ */
+GpuDistanceField::GpuDistanceField(MazeGrid map, bool wrapHorizontal)
+	:	height(map.getHeight()),
+		width(map.getWidth()),
+		wrap(wrapHorizontal),
+		goalY(-1),
+		goalX(-1),
+		lastPasses(0),
+		relax("shaders/distance.comp"),
+		route("shaders/route.comp"),
+		startCapacity(0),
+		stepCapacity(0)
+{
+	std::vector<unsigned char> walls(width * height);
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			walls[y * width + x] = map(y, x) == 1 ? 255 : 0;
+
+	glGenTextures(1, &wallTexture);
+	glBindTexture(GL_TEXTURE_2D, wallTexture);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, width, height, 0, GL_RED, GL_UNSIGNED_BYTE, walls.data());
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	glGenBuffers(1, &distanceBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, distanceBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(int) * width * height, nullptr, GL_DYNAMIC_COPY);
+
+	groupsX = (width + GROUP_SIZE - 1) / GROUP_SIZE;
+	groupsY = (height + GROUP_SIZE - 1) / GROUP_SIZE;
+	glGenBuffers(1, &groupBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, groupBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(int) * groupsX * groupsY, nullptr, GL_DYNAMIC_COPY);
+
+	glGenBuffers(1, &changedBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, changedBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(unsigned int), nullptr, GL_DYNAMIC_READ);
+
+	glGenBuffers(1, &startBuffer);
+	glGenBuffers(1, &stepBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/**
+ * @brief Destroy the GpuDistanceField::GpuDistanceField object
+ *
+ */
+GpuDistanceField::~GpuDistanceField()
+{
+	glDeleteTextures(1, &wallTexture);
+	glDeleteBuffers(1, &distanceBuffer);
+	glDeleteBuffers(1, &changedBuffer);
+	glDeleteBuffers(1, &groupBuffer);
+	glDeleteBuffers(1, &startBuffer);
+	glDeleteBuffers(1, &stepBuffer);
+	glDeleteProgram(relax.ID);
+	glDeleteProgram(route.ID);
+}
+
+/**
+ * @brief Checks wheter the current context can run the compute shaders.
+ *
+ * @return true - The context is GL 4.3 or newer
+ */
+bool GpuDistanceField::isSupported()
+{
+	GLint major = 0, minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	return major > 4 || (major == 4 && minor >= 3);
+}
+
+/**
+ * @brief 	Computes the distance from every tile to the goal. Every tile starts unreached
+ * 			and the goal at 0, then relaxation passes are dispatched until a pass changes
+ * 			nothing. Only the groups around the ones that changed in the last pass do any
+ * 			work, starting with the goal's group. Reading back the changed flag stalls until
+ * 			the gpu has caught up, so it is only read every PASSES_PER_CHECK passes.
+ *
+ * @param goalY - The y coordinate of the goal (the player's tile)
+ * @param goalX - The x coordinate of the goal (the player's tile)
+ * @return int 	- The amount of passes dispatched, 0 and no goal if it is outside the level
+ */
+int GpuDistanceField::build(int goalY, int goalX)
+{
+	lastPasses = 0;
+	if (goalY < 0 || goalY >= height || goalX < 0 || goalX >= width) {
+		this->goalY = this->goalX = -1;	//the field of the last goal is not walked anymore
+		return 0;
+	}
+	this->goalY = goalY;
+	this->goalX = goalX;
+
+	const int zero = 0;
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, distanceBuffer);
+	glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32I, GL_RED_INTEGER, GL_INT, &UNREACHED);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(int) * (goalY * width + goalX), sizeof(int), &zero);
+
+	//The goal counts as changed in pass 1, so its group and the ones around it run first
+	const int first = 1;
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, groupBuffer);
+	glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32I, GL_RED_INTEGER, GL_INT, &zero);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(int) * ((goalY / GROUP_SIZE) * groupsX + goalX / GROUP_SIZE), sizeof(int), &first);
+
+	relax.use();
+	relax.setIVec2("u_Size", width, height);
+	relax.setBool("u_Wrap", wrap);
+	relax.setInt("u_Walls", 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, wallTexture);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, distanceBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, changedBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, groupBuffer);
+
+	unsigned int changed = 1;
+	while (changed) {
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, changedBuffer);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(unsigned int), &zero);
+		for (int i = 0; i < PASSES_PER_CHECK; i++) {
+			relax.setInt("u_Pass", lastPasses + 2);
+			glDispatchCompute(groupsX, groupsY, 1);
+			glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+			lastPasses++;
+		}
+		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+		glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(unsigned int), &changed);
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	return lastPasses;
+}
+
+/**
+ * @brief 	Walks down the distance field from a list of tiles on the gpu, and reads back
+ * 			the first steps of every route. Only maxSteps bytes per tile are read back.
+ *
+ * @param cellsY 	- The y coordinate of every start tile (the ghosts)
+ * @param cellsX 	- The x coordinate of every start tile
+ * @param maxSteps 	- How many steps to walk from every tile
+ * @param steps 	- Resized to cellsY.size() * maxSteps, the steps of tile i start at i * maxSteps,
+ * 					  StepNone after the goal or if the goal can not be reached
+ */
+void GpuDistanceField::getRoutes(const std::vector<int>& cellsY, const std::vector<int>& cellsX, int maxSteps,
+								 std::vector<FlowStep>& steps)
+{
+	int count = cellsY.size();
+	steps.assign(count * maxSteps, StepNone);
+	if (count == 0 || maxSteps <= 0 || goalY == -1)
+		return;
+
+	std::vector<int> starts(count * 2);
+	for (int i = 0; i < count; i++) {
+		starts[i * 2] = cellsX[i];
+		starts[i * 2 + 1] = cellsY[i];
+	}
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, startBuffer);
+	if (startCapacity < count * 2) {
+		startCapacity = count * 2;
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(int) * startCapacity, nullptr, GL_DYNAMIC_DRAW);
+	}
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(int) * count * 2, starts.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, stepBuffer);
+	if (stepCapacity < count * maxSteps) {
+		stepCapacity = count * maxSteps;
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(unsigned int) * stepCapacity, nullptr, GL_DYNAMIC_READ);
+	}
+
+	route.use();
+	route.setIVec2("u_Size", width, height);
+	route.setBool("u_Wrap", wrap);
+	route.setInt("u_StartCount", count);
+	route.setInt("u_MaxSteps", maxSteps);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, distanceBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, startBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, stepBuffer);
+	glDispatchCompute((count + ROUTE_GROUP_SIZE - 1) / ROUTE_GROUP_SIZE, 1, 1);
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+	std::vector<unsigned int> read(count * maxSteps);
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(unsigned int) * read.size(), read.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	for (size_t i = 0; i < read.size(); i++)
+		steps[i] = read[i] < 4 ? (FlowStep)read[i] : StepNone;
+}
+
+/**
+ * @brief Reads back the whole distance field, for checking it against the cpu.
+ *
+ * @param distances - Resized to height * width, -1 for tiles that can not be reached
+ */
+void GpuDistanceField::getDistances(std::vector<int>& distances)
+{
+	distances.resize(width * height);
+	glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, distanceBuffer);
+	glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(int) * distances.size(), distances.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+	for (int& d : distances)
+		if (d >= UNREACHED)
+			d = -1;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file GpuDistanceField.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the GpuDistanceField class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <GL/glew.h>
+#include "Shader.h"
+#include "FlowField.h"
+
+#include <vector>
+
+/**
+ * @class GpuDistanceField
+ * @brief 	The distance field towards the player computed with compute shaders, for
+ * 			generated levels too large for a breadth first search on the cpu every time
+ * 			the player changes tile. The walls are uploaded once as an R8 texture, the
+ * 			distances live in a shader storage buffer and are relaxed pass by pass until a
+ * 			pass changes nothing. Only a short route per ghost is read back. Needs a GL 4.3
+ * 			context (compute shaders and shader storage buffers).
+ */
+class GpuDistanceField
+{
+public:
+	GpuDistanceField(MazeGrid map, bool wrapHorizontal = true);
+	~GpuDistanceField();
+
+	static bool isSupported();
+
+	int  build(int goalY, int goalX);
+	void getRoutes(const std::vector<int>& cellsY, const std::vector<int>& cellsX, int maxSteps,
+				   std::vector<FlowStep>& steps);
+	void getDistances(std::vector<int>& distances);
+
+	inline int getGoalY()		const { return goalY; }
+	inline int getGoalX()		const { return goalX; }
+	inline int getLastPasses()	const { return lastPasses; }	//relaxation passes of the last build
+
+private:
+	int height, width;
+	bool wrap;
+	int goalY, goalX;
+	int lastPasses;
+
+	Shader relax;	//shaders/distance.comp
+	Shader route;	//shaders/route.comp
+
+	unsigned int wallTexture;
+	int groupsX, groupsY;	//work groups of 16x16 tiles
+	unsigned int distanceBuffer, changedBuffer, groupBuffer, startBuffer, stepBuffer;
+	int startCapacity, stepCapacity;	//ints the start and step buffers have room for
+};
@@ -0,0 +1,352 @@
+/**
+ * @file GridBitboard.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class for bit-parallel searches over the walls of the level.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "GridBitboard.h"
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace {
+	/**
+	 * @brief Index of the lowest set bit of a non zero word.
+	 */
+	inline int lowestBit(uint64_t word)
+	{
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, word);
+		return (int)index;
+#else
+		return __builtin_ctzll(word);
+#endif
+	}
+
+	/**
+	 * @brief Amount of set bits in a word.
+	 */
+	inline int popCount(uint64_t word)
+	{
+#if defined(_MSC_VER)
+		return (int)__popcnt64(word);
+#else
+		return __builtin_popcountll(word);
+#endif
+	}
+
+	/**
+	 * @brief 	Spreads every seed bit towards the higher bits for as long as the cells are
+	 * 			open, in 6 steps no matter how long the run is (occluded Kogge-Stone fill).
+	 */
+	inline uint64_t fillUp(uint64_t seeds, uint64_t open)
+	{
+		seeds &= open;
+		seeds |= open & (seeds << 1);	open &= open << 1;
+		seeds |= open & (seeds << 2);	open &= open << 2;
+		seeds |= open & (seeds << 4);	open &= open << 4;
+		seeds |= open & (seeds << 8);	open &= open << 8;
+		seeds |= open & (seeds << 16);	open &= open << 16;
+		seeds |= open & (seeds << 32);
+		return seeds;
+	}
+
+	/**
+	 * @brief Same as fillUp, towards the lower bits.
+	 */
+	inline uint64_t fillDown(uint64_t seeds, uint64_t open)
+	{
+		seeds &= open;
+		seeds |= open & (seeds >> 1);	open &= open >> 1;
+		seeds |= open & (seeds >> 2);	open &= open >> 2;
+		seeds |= open & (seeds >> 4);	open &= open >> 4;
+		seeds |= open & (seeds >> 8);	open &= open >> 8;
+		seeds |= open & (seeds >> 16);	open &= open >> 16;
+		seeds |= open & (seeds >> 32);
+		return seeds;
+	}
+}
+
+/**
+ * @brief Construct a new GridBitboard::GridBitboard object, packing the walls of the map.
+ *
+ * @param map 				- The 2d grid of the maze
+ * @param wrapHorizontal 	- Wheter or not walking off the left/right edge enters on the other side
+ */
+GridBitboard::GridBitboard(MazeGrid map, bool wrapHorizontal)
+	:	height(map.getHeight()),
+		width(map.getWidth()),
+		wordsPerRow(width / 64 + 1),	//always at least one padding bit at the end of a row
+		wrap(wrapHorizontal)
+{
+	size_t words = (size_t)(height + 2) * wordsPerRow + 2;	//empty rows above and below, one word either end
+	open.assign(words, 0);
+	visited.assign(words, 0);
+	frontier.assign(words, 0);
+	next.assign(words, 0);
+
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			if (map(y, x) != 1)
+				open[wordIndex(y, x)] |= 1ull << (x & 63);
+}
+
+/**
+ * @brief Checks wheter or not a cell can be walked on.
+ *
+ * @param y - The y coordinate of the cell
+ * @param x - The x coordinate of the cell
+ * @return true - The cell is inside the map and is not a wall
+ */
+bool GridBitboard::isOpen(int y, int x) const
+{
+	if (y < 0 || y >= height || x < 0 || x >= width)
+		return false;
+	return (open[wordIndex(y, x)] >> (x & 63)) & 1;
+}
+
+/**
+ * @brief Checks wheter or not the last search reached a cell.
+ *
+ * @param y - The y coordinate of the cell
+ * @param x - The x coordinate of the cell
+ * @return true - The cell can be reached from where the last search started
+ */
+bool GridBitboard::isReached(int y, int x) const
+{
+	if (y < 0 || y >= height || x < 0 || x >= width)
+		return false;
+	return (visited[wordIndex(y, x)] >> (x & 63)) & 1;
+}
+
+/**
+ * @brief 	Computes next from frontier for a range of words: every cell next to the
+ * 			frontier (left, right, above or below) that is open and not visited yet.
+ * 			The cells found are added to visited as well.
+ *
+ * @param first - The first word to compute
+ * @param last 	- One past the last word to compute
+ */
+void GridBitboard::expand(size_t first, size_t last)
+{
+	const uint64_t* f = frontier.data();
+	const uint64_t* o = open.data();
+	uint64_t* v = visited.data();
+	uint64_t* n = next.data();
+	const size_t row = wordsPerRow;
+
+	size_t i = first;
+#ifdef __AVX2__
+	for (; i + 4 <= last; i += 4) {
+		__m256i centre = _mm256_loadu_si256((const __m256i*)(f + i));
+		__m256i before = _mm256_loadu_si256((const __m256i*)(f + i - 1));
+		__m256i after  = _mm256_loadu_si256((const __m256i*)(f + i + 1));
+		__m256i above  = _mm256_loadu_si256((const __m256i*)(f + i - row));
+		__m256i below  = _mm256_loadu_si256((const __m256i*)(f + i + row));
+
+		//Shifting by one moves every cell one step sideways, the bit crossing a word boundary comes from the neighbouring word
+		__m256i grown = _mm256_or_si256(
+			_mm256_or_si256(_mm256_slli_epi64(centre, 1), _mm256_srli_epi64(before, 63)),
+			_mm256_or_si256(_mm256_srli_epi64(centre, 1), _mm256_slli_epi64(after, 63)));
+		grown = _mm256_or_si256(grown, _mm256_or_si256(above, below));
+
+		__m256i seen = _mm256_loadu_si256((const __m256i*)(v + i));
+		__m256i found = _mm256_andnot_si256(seen, _mm256_and_si256(grown, _mm256_loadu_si256((const __m256i*)(o + i))));
+		_mm256_storeu_si256((__m256i*)(n + i), found);
+		_mm256_storeu_si256((__m256i*)(v + i), _mm256_or_si256(seen, found));
+	}
+#endif
+	for (; i < last; i++) {
+		uint64_t grown = (f[i] << 1) | (f[i - 1] >> 63) | (f[i] >> 1) | (f[i + 1] << 63) | f[i - row] | f[i + row];
+		n[i] = grown & o[i] & ~v[i];
+		v[i] |= n[i];
+	}
+}
+
+/**
+ * @brief Adds the cells reached through the tunnel, from one end of a row to the other.
+ *
+ * @param firstRow 	- The first row the frontier can be in
+ * @param lastRow 	- The last row the frontier can be in
+ */
+void GridBitboard::expandTunnel(int firstRow, int lastRow)
+{
+	int lastBit = (width - 1) & 63;
+	for (int y = firstRow; y <= lastRow; y++) {
+		size_t left = wordIndex(y, 0), right = wordIndex(y, width - 1);
+		bool fromLeft = frontier[left] & 1;
+		bool fromRight = (frontier[right] >> lastBit) & 1;
+		if (fromRight && (open[left] & ~visited[left] & 1)) {
+			next[left] |= 1;
+			visited[left] |= 1;
+		}
+		if (fromLeft && ((open[right] & ~visited[right]) >> lastBit) & 1) {
+			next[right] |= 1ull << lastBit;
+			visited[right] |= 1ull << lastBit;
+		}
+	}
+}
+
+/**
+ * @brief 	Breadth first search from a cell, one step of the whole frontier at a time.
+ * 			Only the rows the frontier can reach are computed each step.
+ *
+ * @param y 		- The y coordinate of the cell to search from
+ * @param x 		- The x coordinate of the cell to search from
+ * @param distance 	- Optional height * width buffer, filled with the steps to every reached cell
+ * @return int 		- The amount of cells reached, including the start
+ */
+int GridBitboard::search(int y, int x, std::vector<int>* distance)
+{
+	std::fill(visited.begin(), visited.end(), 0);
+	std::fill(frontier.begin(), frontier.end(), 0);
+	std::fill(next.begin(), next.end(), 0);
+	if (!isOpen(y, x))
+		return 0;
+
+	visited[wordIndex(y, x)] = frontier[wordIndex(y, x)] = 1ull << (x & 63);
+	if (distance)
+		(*distance)[y * width + x] = 0;
+
+	int reached = 1;
+	int firstRow = y, lastRow = y;	//the rows the frontier is in
+	for (int step = 1; firstRow <= lastRow; step++) {
+		int from = std::max(firstRow - 1, 0);
+		int to = std::min(lastRow + 1, height - 1);
+		expand(wordIndex(from, 0), wordIndex(to, 0) + wordsPerRow);
+		if (wrap)
+			expandTunnel(firstRow, lastRow);
+
+		//The old frontier is cleared so the buffers can be swapped
+		std::fill(frontier.begin() + wordIndex(firstRow, 0), frontier.begin() + wordIndex(lastRow, 0) + wordsPerRow, 0);
+
+		firstRow = height;
+		lastRow = -1;
+		for (int row = from; row <= to; row++) {
+			size_t begin = wordIndex(row, 0);
+			for (int w = 0; w < wordsPerRow; w++) {
+				uint64_t bits = next[begin + w];
+				if (!bits)
+					continue;
+				firstRow = std::min(firstRow, row);
+				lastRow = row;
+				while (bits) {
+					int cell = row * width + w * 64 + lowestBit(bits);
+					if (distance)
+						(*distance)[cell] = step;
+					reached++;
+					bits &= bits - 1;
+				}
+			}
+		}
+		frontier.swap(next);
+	}
+	return reached;
+}
+
+/**
+ * @brief Fills a buffer with the amount of steps from a goal to every cell.
+ *
+ * @param goalY 	- The y coordinate of the goal
+ * @param goalX 	- The x coordinate of the goal
+ * @param distance 	- height * width buffer, cells that can not be reached are set to -1
+ * @return int 		- The amount of cells reached, 0 if the goal is a wall
+ */
+int GridBitboard::distanceField(int goalY, int goalX, std::vector<int>& distance)
+{
+	std::fill(distance.begin(), distance.end(), -1);
+	return search(goalY, goalX, &distance);
+}
+
+/**
+ * @brief 	Spreads the visited cells of a row along the row as far as the walls allow,
+ * 			carrying between the words of the row and through the tunnel.
+ *
+ * @param row - The row to fill
+ */
+void GridBitboard::fillRow(int row)
+{
+	size_t begin = wordIndex(row, 0);
+	int lastBit = (width - 1) & 63;
+	for (int pass = 0; pass < 2; pass++) {
+		uint64_t carry = 0;
+		for (int w = 0; w < wordsPerRow; w++) {
+			visited[begin + w] = fillUp(visited[begin + w] | carry, open[begin + w]);
+			carry = visited[begin + w] >> 63;
+		}
+		carry = 0;
+		for (int w = wordsPerRow - 1; w >= 0; w--) {
+			visited[begin + w] = fillDown(visited[begin + w] | carry, open[begin + w]);
+			carry = visited[begin + w] << 63;
+		}
+		if (!wrap)
+			break;
+
+		//One end of the row reached through the tunnel lets the fill continue from the other end
+		size_t right = wordIndex(row, width - 1);
+		uint64_t leftEnd = visited[begin] & 1, rightEnd = (visited[right] >> lastBit) & 1;
+		if (leftEnd == rightEnd)
+			break;
+		if (leftEnd)
+			visited[right] |= (open[right] >> lastBit & 1) << lastBit;
+		else
+			visited[begin] |= open[begin] & 1;
+	}
+}
+
+/**
+ * @brief 	Finds every cell that can be reached from a cell, check them with isReached.
+ * 			No distances are needed, so instead of one step at a time every row is filled
+ * 			as far as it goes and the rows are swept down and up until nothing changes.
+ *
+ * @param y 	- The y coordinate of the cell
+ * @param x 	- The x coordinate of the cell
+ * @return int 	- The amount of cells reached, 0 if the cell is a wall
+ */
+int GridBitboard::floodFill(int y, int x)
+{
+	std::fill(visited.begin(), visited.end(), 0);
+	if (!isOpen(y, x))
+		return 0;
+	visited[wordIndex(y, x)] = 1ull << (x & 63);
+	fillRow(y);
+
+	bool changed = true;
+	while (changed) {
+		changed = false;
+		for (int direction = 1; direction >= -1; direction -= 2) {
+			int first = direction == 1 ? 1 : height - 2;
+			for (int row = first; row >= 0 && row < height; row += direction) {
+				size_t begin = wordIndex(row, 0), from = wordIndex(row - direction, 0);
+				bool grew = false;
+				for (int w = 0; w < wordsPerRow; w++) {
+					uint64_t entered = visited[from + w] & open[begin + w] & ~visited[begin + w];
+					if (entered) {
+						visited[begin + w] |= entered;
+						grew = true;
+					}
+				}
+				if (grew) {
+					fillRow(row);
+					changed = true;
+				}
+			}
+		}
+	}
+
+	int reached = 0;
+	for (uint64_t word : visited)
+		reached += popCount(word);
+	return reached;
+}
@@ -0,0 +1,57 @@
+/**
+ * @file GridBitboard.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the GridBitboard class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "MazeGrid.h"
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @class GridBitboard
+ * @brief 	The walls of the level packed as one bit per cell, 64 cells to a word. A breadth
+ * 			first search advances its whole frontier one step at a time with shifts, ANDs and
+ * 			ORs over every word (four words per instruction when built with AVX2), instead
+ * 			of visiting the cells one by one from a queue. A flood fill, which does not need
+ * 			the distances, fills whole rows at once instead.
+ *
+ * 			Every row is padded to at least one unused bit and there is an empty row above
+ * 			and below the map, so the kernel never has to check the edges.
+ */
+class GridBitboard
+{
+public:
+	GridBitboard(MazeGrid map, bool wrapHorizontal = true);
+
+	int  distanceField(int goalY, int goalX, std::vector<int>& distance);
+	int  floodFill(int y, int x);
+
+	bool isOpen(int y, int x) const;
+	bool isReached(int y, int x) const;	//reached by the last search
+	inline int getWordsPerRow() const { return wordsPerRow; }
+
+private:
+	int height, width;
+	int wordsPerRow;
+	bool wrap;	//cells on the left and right edge are neighbours, used by the tunnel
+
+	std::vector<uint64_t> open;		//1 for every cell that is not a wall
+	std::vector<uint64_t> visited;	//cells reached by the search
+	std::vector<uint64_t> frontier;	//cells reached in the last step
+	std::vector<uint64_t> next;		//cells reached in this step
+
+	inline size_t wordIndex(int y, int x) const { return 1 + (size_t)(y + 1) * wordsPerRow + (x >> 6); }
+
+	int  search(int y, int x, std::vector<int>* distance);
+	void expand(size_t first, size_t last);
+	void expandTunnel(int firstRow, int lastRow);
+	void fillRow(int row);
+};
@@ -0,0 +1,238 @@
+/**
+ * @file GridVisibility.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Source code for the GridVisibility class
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "GridVisibility.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+	const float RAY_SPACING = 0.25f;	//tiles between two neighbouring rays at the far plane
+	const int	MAX_RAYS = 4096;
+	const float WALL_HEIGHT = 1.f;		//the camera sees over the walls from above this
+	const float PI = 3.14159265f;
+}
+
+/**
+ * @brief Construct a new GridVisibility::GridVisibility object, nothing is visible before the first update.
+ *
+ * @param grid - The tiles of the level
+ */
+GridVisibility::GridVisibility(MazeGrid grid)
+	:	m_Grid(grid),
+		width(grid.getWidth()),
+		height(grid.getHeight()),
+		windowX(0),
+		windowZ(0),
+		windowWidth(0),
+		windowHeight(0),
+		rayCount(0)
+{
+}
+
+/**
+ * @brief 	Casts the rays of a camera. The horizontal field of view and how far the rays go
+ * 			are taken from the corners of the far plane, so a camera looking up or down
+ * 			casts them in a wider angle, all around when it looks nearly straight up or down.
+ *
+ * @param projection 	- The projection matrix
+ * @param view 			- The view matrix
+ */
+void GridVisibility::update(const glm::mat4& projection, const glm::mat4& view)
+{
+	glm::mat4 inverseView = glm::inverse(view);
+	glm::vec3 position(inverseView[3]);
+	glm::vec2 forward(-inverseView[2].x, -inverseView[2].z);
+	glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+
+	glm::vec2 corners[4];
+	float distance = 0;
+	for (int i = 0; i < 4; i++) {
+		glm::vec4 corner = inverseViewProjection * glm::vec4(i & 1 ? 1.f : -1.f, i & 2 ? 1.f : -1.f, 1.f, 1.f);
+		corners[i] = glm::vec2(corner.x / corner.w - position.x, corner.z / corner.w - position.z);
+		distance = std::max(distance, glm::length(corners[i]));
+	}
+
+	int cameraX = (int)std::floor(position.x), cameraZ = (int)std::floor(position.z);
+	int reach = (int)std::ceil(distance) + 1;
+	windowX = std::max(0, cameraX - reach);
+	windowZ = std::max(0, cameraZ - reach);
+	windowWidth = std::max(0, std::min(width, cameraX + reach + 1) - windowX);
+	windowHeight = std::max(0, std::min(height, cameraZ + reach + 1) - windowZ);
+	visible.assign((size_t)windowWidth * windowHeight, 0);
+	visibleTiles.clear();
+	rayCount = 0;
+	if (windowWidth == 0 || windowHeight == 0)
+		return;
+
+	//Outside of the maze, inside a wall or above the walls nothing hides anything
+	bool inside = cameraX >= 0 && cameraX < width && cameraZ >= 0 && cameraZ < height;
+	if (!inside || m_Grid.isWall(cameraZ, cameraX) || position.y >= WALL_HEIGHT) {
+		markAll();
+		return;
+	}
+
+	//The angles of the far corners around the direction of the camera on the floor
+	float first = 0, last = 0;
+	bool around = glm::length(forward) < 1e-4f;
+	for (int i = 0; i < 4 && !around; i++) {
+		if (glm::length(corners[i]) < 1e-4f)
+			around = true;
+		else {
+			float angle = std::atan2(forward.x * corners[i].y - forward.y * corners[i].x, glm::dot(forward, corners[i]));
+			first = i == 0 ? angle : std::min(first, angle);
+			last = i == 0 ? angle : std::max(last, angle);
+		}
+	}
+	if (around || last - first >= PI) {
+		first = -PI;
+		last = PI;
+	}
+
+	float base = around ? 0.f : std::atan2(forward.y, forward.x);
+	rayCount = std::min(MAX_RAYS, (int)std::ceil((last - first) * distance / RAY_SPACING) + 1);
+	for (int i = 0; i < rayCount; i++) {
+		float angle = base + first + (rayCount > 1 ? (last - first) * i / (rayCount - 1) : 0.f);
+		castRay(position.x, position.z, std::cos(angle), std::sin(angle), distance);
+	}
+}
+
+/**
+ * @brief Whether a tile was visible at the last update.
+ *
+ * @param x - The column of the tile
+ * @param z - The row of the tile
+ */
+bool GridVisibility::isVisible(int x, int z) const
+{
+	if (x < windowX || x >= windowX + windowWidth || z < windowZ || z >= windowZ + windowHeight)
+		return false;
+	return visible[(size_t)(z - windowZ) * windowWidth + x - windowX] != 0;
+}
+
+/**
+ * @brief Whether any tile of an area was visible at the last update.
+ *
+ * @param firstX 	- The first column of the area
+ * @param firstZ 	- The first row of the area
+ * @param lastX 	- One past the last column of the area
+ * @param lastZ 	- One past the last row of the area
+ */
+bool GridVisibility::isAreaVisible(int firstX, int firstZ, int lastX, int lastZ) const
+{
+	firstX = std::max(firstX, windowX);
+	firstZ = std::max(firstZ, windowZ);
+	lastX = std::min(lastX, windowX + windowWidth);
+	lastZ = std::min(lastZ, windowZ + windowHeight);
+	for (int z = firstZ; z < lastZ; z++) {
+		const uint8_t* row = &visible[(size_t)(z - windowZ) * windowWidth];
+		for (int x = firstX; x < lastX; x++)
+			if (row[x - windowX])
+				return true;
+	}
+	return false;
+}
+
+/**
+ * @brief Whether any tile under a square on the floor was visible at the last update.
+ *
+ * @param x 		- The x coordinate of the middle of the square
+ * @param z 		- The z coordinate of the middle of the square
+ * @param radius 	- Half the width of the square
+ */
+bool GridVisibility::isAreaVisible(float x, float z, float radius) const
+{
+	return isAreaVisible((int)std::floor(x - radius), (int)std::floor(z - radius),
+						 (int)std::floor(x + radius) + 1, (int)std::floor(z + radius) + 1);
+}
+
+/**
+ * @brief 	Walks a ray from tile to tile (Amanatides and Woo's DDA) until it hits a wall,
+ * 			leaves the level or goes further than the distance.
+ *
+ * @param originX 	- The x coordinate the ray starts at
+ * @param originZ 	- The z coordinate the ray starts at
+ * @param dirX 		- The x coordinate of the ray's direction, of length one with dirZ
+ * @param dirZ 		- The z coordinate of the ray's direction
+ * @param distance 	- How far the ray goes
+ */
+void GridVisibility::castRay(float originX, float originZ, float dirX, float dirZ, float distance)
+{
+	const float infinity = std::numeric_limits<float>::infinity();
+	int x = (int)std::floor(originX), z = (int)std::floor(originZ);
+	int stepX = dirX > 0 ? 1 : -1, stepZ = dirZ > 0 ? 1 : -1;
+	float deltaX = dirX != 0 ? 1.f / std::abs(dirX) : infinity;
+	float deltaZ = dirZ != 0 ? 1.f / std::abs(dirZ) : infinity;
+	float nextX = dirX != 0 ? (dirX > 0 ? x + 1 - originX : originX - x) * deltaX : infinity;
+	float nextZ = dirZ != 0 ? (dirZ > 0 ? z + 1 - originZ : originZ - z) * deltaZ : infinity;
+
+	mark(x, z);
+	while (true) {
+		float travelled;
+		if (nextX < nextZ) {
+			x += stepX;
+			travelled = nextX;
+			nextX += deltaX;
+		}
+		else {
+			z += stepZ;
+			travelled = nextZ;
+			nextZ += deltaZ;
+		}
+		if (travelled > distance || x < 0 || x >= width || z < 0 || z >= height)
+			return;
+		mark(x, z);
+		if (m_Grid.isWall(z, x))
+			return;
+	}
+}
+
+/**
+ * @brief 	Marks a tile a ray has reached as visible. The walls next to a tile that is not a
+ * 			wall are marked too, a ray passing along a wall does not always step into it.
+ *
+ * @param x - The column of the tile
+ * @param z - The row of the tile
+ */
+void GridVisibility::mark(int x, int z)
+{
+	if (x < windowX || x >= windowX + windowWidth || z < windowZ || z >= windowZ + windowHeight)
+		return;
+	uint8_t& tile = visible[(size_t)(z - windowZ) * windowWidth + x - windowX];
+	bool wall = m_Grid.isWall(z, x);
+	if (tile && !wall)
+		return;
+	tile = 1;
+	if (wall)
+		return;
+	visibleTiles.push_back(glm::ivec2(x, z));
+
+	const int neighbourX[4] = { 1, -1, 0, 0 }, neighbourZ[4] = { 0, 0, 1, -1 };
+	for (int i = 0; i < 4; i++) {
+		int wallX = x + neighbourX[i], wallZ = z + neighbourZ[i];
+		if (wallX >= windowX && wallX < windowX + windowWidth && wallZ >= windowZ && wallZ < windowZ + windowHeight &&
+			m_Grid.isWall(wallZ, wallX))
+			visible[(size_t)(wallZ - windowZ) * windowWidth + wallX - windowX] = 1;
+	}
+}
+
+/**
+ * @brief Marks every tile of the window as visible.
+ *
+ */
+void GridVisibility::markAll()
+{
+	std::fill(visible.begin(), visible.end(), 1);
+	for (int z = windowZ; z < windowZ + windowHeight; z++)
+		for (int x = windowX; x < windowX + windowWidth; x++)
+			if (!m_Grid.isWall(z, x))
+				visibleTiles.push_back(glm::ivec2(x, z));
+}
@@ -0,0 +1,56 @@
+/**
+ * @file GridVisibility.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the GridVisibility class
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "MazeGrid.h"
+
+/**
+ * @class GridVisibility
+ * @brief 	The tiles the camera can see. The walls of the maze go from the floor to the top
+ * 			of the camera's view whenever it is below them, so what is visible only depends
+ * 			on the grid: rays are cast through it across the horizontal field of view and
+ * 			every tile they pass, and the walls around those, is visible. Only a window of
+ * 			tiles around the camera as wide as the far plane is kept, whatever the size of
+ * 			the level.
+ */
+class GridVisibility
+{
+public:
+	GridVisibility(MazeGrid grid);
+
+	void update(const glm::mat4& projection, const glm::mat4& view);
+
+	bool isVisible(int x, int z) const;
+	bool isAreaVisible(int firstX, int firstZ, int lastX, int lastZ) const;
+	bool isAreaVisible(float x, float z, float radius) const;
+
+	inline const std::vector<glm::ivec2>& getVisibleTiles() const { return visibleTiles; }	//the tiles that are not walls
+	inline int getRayCount() const { return rayCount; }
+
+private:
+	MazeGrid m_Grid;
+	int width, height;
+
+	//The window of tiles of the last update, visible[(z - windowZ) * windowWidth + x - windowX]
+	int windowX, windowZ,
+		windowWidth, windowHeight;
+	std::vector<uint8_t> visible;
+	std::vector<glm::ivec2> visibleTiles;
+	int rayCount;
+
+	void castRay(float originX, float originZ, float dirX, float dirZ, float distance);
+	void mark(int x, int z);
+	void markAll();
+};
@@ -0,0 +1,607 @@
+/**
+ * @file HierarchicalGraph.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class for hierarchical pathfinding over clusters of the maze.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "HierarchicalGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <thread>
+
+namespace {
+	const int offsetY[4] = { -1, 1, 0, 0 }; //same order as FlowStep
+	const int offsetX[4] = { 0, 0, -1, 1 };
+
+	/**
+	 * @brief Comparison used for the open list, the cheapest entry is on top of the heap.
+	 */
+	struct CompareCost {
+		template<typename T>
+		bool operator()(T const& e1, T const& e2) const { return e1.fCost > e2.fCost; }
+	};
+}
+
+/**
+ * @brief Construct a new HierarchicalGraph::HierarchicalGraph object. Does not build the graph.
+ *
+ * @param map 					- The 2d grid of the maze
+ * @param wrapHorizontal 		- Wheter or not walking off the left/right edge enters on the other side
+ * @param clusterSize 			- Width and height of a cluster in cells
+ * @param budgetMicroseconds 	- How long a query may search the abstract graph, 0 for no limit
+ */
+HierarchicalGraph::HierarchicalGraph(MazeGrid map, bool wrapHorizontal,
+									 int clusterSize, int budgetMicroseconds)
+	:	height(map.getHeight()),
+		width(map.getWidth()),
+		wrap(wrapHorizontal),
+		clusterSize(clusterSize),
+		budget(budgetMicroseconds),
+		expansions(0),
+		partial(false),
+		generation(0)
+{
+	clustersX = (width + clusterSize - 1) / clusterSize;
+	clustersY = (height + clusterSize - 1) / clusterSize;
+
+	walkable.assign(height * width, 0);
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			walkable[y * width + x] = map(y, x) != 1;
+	nodeOfCell.assign(height * width, -1);
+
+	int clusters = clustersX * clustersY;
+	clusterNodes.resize(clusters);
+	intraCost.resize(clusters);
+	borders.resize(clusters * 2);
+
+	startDistance.resize(clusterSize * clusterSize);
+	goalDistance.resize(clusterSize * clusterSize);
+	startSteps.resize(clusterSize * clusterSize);
+	clusterQueue.resize(clusterSize * clusterSize);
+}
+
+/**
+ * @brief Finds the cluster a cell belongs to.
+ *
+ * @param cell 	- y * width + x of the cell
+ * @return int 	- The cluster id, clusters are numbered row by row
+ */
+int HierarchicalGraph::clusterOf(int cell) const
+{
+	return (cell / width / clusterSize) * clustersX + (cell % width) / clusterSize;
+}
+
+/**
+ * @brief Gives the cells covered by a cluster, the clusters along the right and bottom edge can be smaller.
+ *
+ * @param cluster 	- The cluster id
+ * @param y0 		- Is set to the first row
+ * @param x0 		- Is set to the first column
+ * @param y1 		- Is set to one past the last row
+ * @param x1 		- Is set to one past the last column
+ */
+void HierarchicalGraph::clusterBounds(int cluster, int& y0, int& x0, int& y1, int& x1) const
+{
+	y0 = (cluster / clustersX) * clusterSize;
+	x0 = (cluster % clustersX) * clusterSize;
+	y1 = std::min(y0 + clusterSize, height);
+	x1 = std::min(x0 + clusterSize, width);
+}
+
+/**
+ * @brief Maps a cell to its index in the clusterSize x clusterSize scratch buffers.
+ *
+ * @param cluster 	- The cluster containing the cell
+ * @param cell 		- y * width + x of the cell
+ * @return int
+ */
+int HierarchicalGraph::localIndex(int cluster, int cell) const
+{
+	int y0 = (cluster / clustersX) * clusterSize;
+	int x0 = (cluster % clustersX) * clusterSize;
+	return (cell / width - y0) * clusterSize + (cell % width - x0);
+}
+
+/**
+ * @brief Manhattan distance between two cells, taking the tunnel into account.
+ *
+ * @param cell 	- y * width + x of the first cell
+ * @param goal 	- y * width + x of the second cell
+ * @return int
+ */
+int HierarchicalGraph::heuristic(int cell, int goal) const
+{
+	int dy = abs(cell / width - goal / width);
+	int dx = abs(cell % width - goal % width);
+	if (wrap)
+		dx = std::min(dx, width - dx);
+	return dy + dx;
+}
+
+/**
+ * @brief Returns the node of a cell, making the cell a node first if it is not one already.
+ *
+ * @param cell 	- y * width + x of the cell
+ * @return int 	- The node id
+ */
+int HierarchicalGraph::addNode(int cell)
+{
+	if (nodeOfCell[cell] != -1)
+		return nodeOfCell[cell];
+
+	int node;
+	if (!freeNodes.empty()) {
+		node = freeNodes.back();
+		freeNodes.pop_back();
+	}
+	else {
+		node = nodes.size();
+		nodes.emplace_back();
+	}
+	nodes[node].cell = cell;
+	nodes[node].cluster = clusterOf(cell);
+	nodes[node].slot = -1;
+	nodes[node].links.clear();
+	nodeOfCell[cell] = node;
+	return node;
+}
+
+/**
+ * @brief Removes the link between two nodes. Nodes left without any links are removed.
+ *
+ * @param from 	- The first node
+ * @param to 	- The second node
+ */
+void HierarchicalGraph::unlink(int from, int to)
+{
+	int ends[2] = { from, to };
+	for (int i = 0; i < 2; i++) {
+		auto& links = nodes[ends[i]].links;
+		auto found = std::find(links.begin(), links.end(), ends[1 - i]);
+		if (found != links.end())
+			links.erase(found);
+	}
+	for (int i = 0; i < 2; i++)
+		if (nodes[ends[i]].links.empty() && nodeOfCell[nodes[ends[i]].cell] == ends[i]) {
+			nodeOfCell[nodes[ends[i]].cell] = -1;
+			freeNodes.push_back(ends[i]);
+		}
+}
+
+/**
+ * @brief 	Finds the entrances across the right or bottom border of a cluster, replacing
+ * 			the ones found before. Every run of open cells facing each other becomes one
+ * 			transition in the middle, long runs get one at each end instead.
+ *
+ * @param cluster 	- The cluster owning the border
+ * @param side 		- 0 for the right border, 1 for the bottom border
+ */
+void HierarchicalGraph::makeBorder(int cluster, int side)
+{
+	auto& border = borders[cluster * 2 + side];
+	for (const auto& transition : border)
+		unlink(transition.from, transition.to);
+	border.clear();
+
+	int y0, x0, y1, x1;
+	clusterBounds(cluster, y0, x0, y1, x1);
+
+	//The cells along the border, and the cells facing them in the next cluster
+	int length, first, step, across;
+	if (side == 0) {
+		int x = x1 - 1;
+		int nextX = x1;
+		if (nextX == width) {
+			if (!wrap)	//the tunnel
+				return;
+			nextX = 0;
+		}
+		length = y1 - y0;
+		first = y0 * width + x;
+		step = width;
+		across = nextX - x;
+	}
+	else {
+		if (y1 == height)
+			return;
+		length = x1 - x0;
+		first = (y1 - 1) * width + x0;
+		step = 1;
+		across = width;
+	}
+
+	const int longEntrance = 6;
+	int runStart = -1;
+	for (int i = 0; i <= length; i++) {
+		int cell = first + i * step;
+		bool open = i < length && walkable[cell] && walkable[cell + across];
+		if (open && runStart == -1)
+			runStart = i;
+		if (open || runStart == -1)
+			continue;
+
+		int runEnd = i - 1;
+		int picks[2] = { (runStart + runEnd) / 2, -1 };
+		if (runEnd - runStart + 1 >= longEntrance) {
+			picks[0] = runStart;
+			picks[1] = runEnd;
+		}
+		for (int p = 0; p < 2 && picks[p] != -1; p++) {
+			int a = first + picks[p] * step;
+			int from = addNode(a);
+			int to = addNode(a + across);
+			nodes[from].links.push_back(to);
+			nodes[to].links.push_back(from);
+			border.push_back({ from, to });
+		}
+		runStart = -1;
+	}
+}
+
+/**
+ * @brief 	Breadth first search from a cell that never leaves its cluster.
+ *
+ * @param cluster 	- The cluster to search
+ * @param cell 		- y * width + x of the cell to search from
+ * @param distance 	- clusterSize^2 buffer, filled with the steps to every cell, -1 if unreached
+ * @param steps 	- Optional clusterSize^2 buffer, filled with the step used to enter every cell
+ * @param queue 	- clusterSize^2 scratch buffer
+ */
+void HierarchicalGraph::searchCluster(int cluster, int cell, std::vector<int>& distance,
+									  std::vector<unsigned char>* steps, std::vector<int>& queue) const
+{
+	int y0, x0, y1, x1;
+	clusterBounds(cluster, y0, x0, y1, x1);
+	std::fill(distance.begin(), distance.end(), -1);
+
+	int head = 0, tail = 0;
+	distance[localIndex(cluster, cell)] = 0;
+	queue[tail++] = cell;
+	while (head < tail) {
+		int current = queue[head++];
+		int y = current / width, x = current % width;
+		int currentDistance = distance[localIndex(cluster, current)];
+		for (int d = 0; d < 4; d++) {
+			int ny = y + offsetY[d], nx = x + offsetX[d];
+			if (ny < y0 || ny >= y1 || nx < x0 || nx >= x1 || !walkable[ny * width + nx])
+				continue;
+			int local = (ny - y0) * clusterSize + (nx - x0);
+			if (distance[local] != -1)
+				continue;
+			distance[local] = currentDistance + 1;
+			if (steps)
+				(*steps)[local] = d;
+			queue[tail++] = ny * width + nx;
+		}
+	}
+}
+
+/**
+ * @brief Collects the nodes of a cluster and precomputes the cost between every pair of them.
+ *
+ * @param cluster 	- The cluster to rebuild
+ * @param distance 	- clusterSize^2 scratch buffer
+ * @param queue 	- clusterSize^2 scratch buffer
+ */
+void HierarchicalGraph::makeCluster(int cluster, std::vector<int>& distance, std::vector<int>& queue)
+{
+	int y0, x0, y1, x1;
+	clusterBounds(cluster, y0, x0, y1, x1);
+
+	auto& members = clusterNodes[cluster];
+	members.clear();
+	for (int y = y0; y < y1; y++)
+		for (int x = x0; x < x1; x++)
+			if (nodeOfCell[y * width + x] != -1) {
+				nodes[nodeOfCell[y * width + x]].slot = members.size();
+				members.push_back(nodeOfCell[y * width + x]);
+			}
+
+	int count = members.size();
+	auto& costs = intraCost[cluster];
+	costs.assign(count * count, -1);
+	for (int i = 0; i < count; i++) {
+		searchCluster(cluster, nodes[members[i]].cell, distance, nullptr, queue);
+		for (int j = 0; j < count; j++)
+			costs[i * count + j] = distance[localIndex(cluster, nodes[members[j]].cell)];
+	}
+}
+
+/**
+ * @brief 	Finds every entrance and precomputes the costs inside every cluster. The
+ * 			clusters are independent, so they are split over several threads.
+ *
+ * @param threadCount - How many threads to use, 0 uses one per hardware thread
+ */
+void HierarchicalGraph::build(unsigned int threadCount)
+{
+	nodes.clear();
+	freeNodes.clear();
+	std::fill(nodeOfCell.begin(), nodeOfCell.end(), -1);
+	for (auto& border : borders)
+		border.clear();
+
+	int clusters = clustersX * clustersY;
+	for (int c = 0; c < clusters; c++) {
+		makeBorder(c, 0);
+		makeBorder(c, 1);
+	}
+
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	threadCount = std::max(1u, std::min(threadCount, (unsigned int)clusters));
+
+	//Every thread builds every threadCount'th cluster, with its own scratch buffers
+	auto worker = [this, clusters, threadCount](unsigned int first) {
+		std::vector<int> distance(clusterSize * clusterSize), queue(clusterSize * clusterSize);
+		for (int c = first; c < clusters; c += threadCount)
+			makeCluster(c, distance, queue);
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned int i = 1; i < threadCount; i++)
+		threads.emplace_back(worker, i);
+	worker(0);
+	for (auto& thread : threads)
+		thread.join();
+
+	reserveScratch();
+}
+
+/**
+ * @brief 	Grows the search scratch to fit every node plus the start and goal, so queries
+ * 			never allocate.
+ *
+ */
+void HierarchicalGraph::reserveScratch()
+{
+	size_t size = nodes.size() + 2;
+	if (stamp.size() < size) {
+		stamp.resize(size, 0);
+		gCost.resize(size);
+		parent.resize(size);
+	}
+	openList.reserve(size);
+}
+
+/**
+ * @brief 	Adds or removes a wall. The entrances are only found again on the borders
+ * 			the cell lies on, and only the clusters on either side of those are rebuilt.
+ *
+ * @param y 	- The y coordinate of the cell
+ * @param x 	- The x coordinate of the cell
+ * @param wall 	- Wheter the cell should be a wall
+ */
+void HierarchicalGraph::setWall(int y, int x, bool wall)
+{
+	if (y < 0 || y >= height || x < 0 || x >= width || walkable[y * width + x] == !wall)
+		return;
+	walkable[y * width + x] = !wall;
+
+	int cluster = clusterOf(y * width + x);
+	int y0, x0, y1, x1;
+	clusterBounds(cluster, y0, x0, y1, x1);
+
+	int rebuild[5] = { cluster, -1, -1, -1, -1 };
+	int count = 1;
+	auto remake = [&](int owner, int side, int other) {
+		makeBorder(owner, side);
+		rebuild[count++] = other;
+	};
+
+	int column = cluster % clustersX;
+	int leftCluster = column > 0 ? cluster - 1 : (wrap ? cluster + clustersX - 1 : -1);
+	int rightCluster = column < clustersX - 1 ? cluster + 1 : (wrap ? cluster - clustersX + 1 : -1);
+	if (x == x1 - 1 && rightCluster != -1)
+		remake(cluster, 0, rightCluster);
+	if (x == x0 && leftCluster != -1)
+		remake(leftCluster, 0, leftCluster);
+	if (y == y1 - 1 && y1 < height)
+		remake(cluster, 1, cluster + clustersX);
+	if (y == y0 && y0 > 0)
+		remake(cluster - clustersX, 1, cluster - clustersX);
+
+	for (int i = 0; i < count; i++)
+		if (std::find(rebuild, rebuild + i, rebuild[i]) == rebuild + i)
+			makeCluster(rebuild[i], goalDistance, clusterQueue);
+	reserveScratch();
+}
+
+/**
+ * @brief Updates the cost of a node if the new cost is lower, and adds it to the open list.
+ *
+ * @param node 		- The node reached
+ * @param newCost 	- The cost of reaching it
+ * @param from 		- The node it was reached from
+ * @param hCost 	- The heuristic from the node to the goal
+ */
+void HierarchicalGraph::relax(int node, int newCost, int from, int hCost)
+{
+	if (stamp[node] < generation || (stamp[node] == generation && newCost < gCost[node])) {
+		stamp[node] = generation;
+		gCost[node] = newCost;
+		parent[node] = from;
+		openList.push_back({ newCost + hCost, node });
+		std::push_heap(openList.begin(), openList.end(), CompareCost());
+	}
+}
+
+/**
+ * @brief 	Refines the first segment of a path. A neighbour of the start is stepped to
+ * 			directly (it can be across a border), cells further away are inside the start
+ * 			cluster and are followed back through the breadth first search from the start.
+ *
+ * @param start 	- y * width + x of the start
+ * @param cell 		- y * width + x of the first cell on the path that is not the start
+ * @param segment 	- Optional, filled with every step from the start to the cell
+ * @return FlowStep - The first step from the start
+ */
+FlowStep HierarchicalGraph::firstStepTowards(int start, int cell, std::vector<FlowStep>* segment) const
+{
+	if (segment)
+		segment->clear();
+	for (int d = 0; d < 4; d++) {
+		int ny = start / width + offsetY[d];
+		int nx = start % width + offsetX[d];
+		if (wrap)	//the tunnel
+			nx = (nx + width) % width;
+		if (ny * width + nx == cell) {
+			if (segment)
+				segment->push_back((FlowStep)d);
+			return (FlowStep)d;
+		}
+	}
+
+	int cluster = clusterOf(start);
+	if (clusterOf(cell) != cluster || startDistance[localIndex(cluster, cell)] <= 0)
+		return StepNone;
+	while (true) {
+		unsigned char step = startSteps[localIndex(cluster, cell)];
+		if (segment)
+			segment->push_back((FlowStep)step);
+		int previous = (cell / width - offsetY[step]) * width + (cell % width - offsetX[step]);
+		if (previous == start) {
+			if (segment)
+				std::reverse(segment->begin(), segment->end());
+			return (FlowStep)step;
+		}
+		cell = previous;
+	}
+}
+
+/**
+ * @brief 	Finds a path on the abstract graph and returns the first step along it. The start
+ * 			and goal are connected to the entrances of their clusters with a breadth first
+ * 			search inside the cluster, so a query costs two cluster sized searches plus the
+ * 			abstract search, which stops when the time budget runs out.
+ *
+ * @param startY 	- The y coordinate of the start
+ * @param startX 	- The x coordinate of the start
+ * @param goalY 	- The y coordinate of the goal
+ * @param goalX 	- The x coordinate of the goal
+ * @param firstStep - Is set to the first step along the path
+ * @param segment 	- Optional, filled with the steps of the whole first segment (to the first entrance)
+ * @return int 		- The length of the path (of the part found, if out of budget),
+ * 					  0 if start is the goal and -1 if there is no path
+ */
+int HierarchicalGraph::FindPath(int startY, int startX, int goalY, int goalX, FlowStep& firstStep,
+								std::vector<FlowStep>* segment)
+{
+	auto begin = std::chrono::steady_clock::now();
+	expansions = 0;
+	partial = false;
+	firstStep = StepNone;
+	if (segment)
+		segment->clear();
+	if (startY < 0 || startY >= height || startX < 0 || startX >= width ||
+		goalY < 0 || goalY >= height || goalX < 0 || goalX >= width)
+		return -1;
+
+	int start = startY * width + startX;
+	int goal = goalY * width + goalX;
+	if (!walkable[start] || !walkable[goal])
+		return -1;
+	if (start == goal)
+		return 0;
+
+	int startCluster = clusterOf(start);
+	int goalCluster = clusterOf(goal);
+	searchCluster(startCluster, start, startDistance, &startSteps, clusterQueue);
+	searchCluster(goalCluster, goal, goalDistance, nullptr, clusterQueue);
+
+	//The start and goal are two extra nodes after the real ones
+	int startNode = nodes.size();
+	int goalNode = startNode + 1;
+	reserveScratch();
+	generation += 2; //generation: discovered, generation + 1: closed
+	if (generation < 2) {
+		std::fill(stamp.begin(), stamp.end(), 0u);
+		generation = 2;
+	}
+	openList.clear();
+
+	relax(startNode, 0, -1, heuristic(start, goal));
+
+	int end = -1;
+	int closest = -1, closestH = INT_MAX;
+	while (!openList.empty()) {
+		std::pop_heap(openList.begin(), openList.end(), CompareCost());
+		OpenEntry entry = openList.back();
+		openList.pop_back();
+
+		int node = entry.node;
+		if (stamp[node] == generation + 1)	//already expanded through a cheaper entry
+			continue;
+		stamp[node] = generation + 1;
+		expansions++;
+		if (node == goalNode) {
+			end = goalNode;
+			break;
+		}
+
+		int g = gCost[node];
+		if (node == startNode) {
+			for (int member : clusterNodes[startCluster]) {
+				int d = startDistance[localIndex(startCluster, nodes[member].cell)];
+				if (d != -1)
+					relax(member, d, node, heuristic(nodes[member].cell, goal));
+			}
+			if (startCluster == goalCluster && startDistance[localIndex(startCluster, goal)] != -1)
+				relax(goalNode, startDistance[localIndex(startCluster, goal)], node, 0);
+			continue;
+		}
+
+		const ClusterNode& current = nodes[node];
+		int h = heuristic(current.cell, goal);
+		if (h < closestH) {
+			closestH = h;
+			closest = node;
+		}
+
+		const auto& members = clusterNodes[current.cluster];
+		const auto& costs = intraCost[current.cluster];
+		int count = members.size();
+		for (int j = 0; j < count; j++) {
+			int cost = costs[current.slot * count + j];
+			if (cost > 0)
+				relax(members[j], g + cost, node, heuristic(nodes[members[j]].cell, goal));
+		}
+		for (int link : current.links)
+			relax(link, g + 1, node, heuristic(nodes[link].cell, goal));
+		if (current.cluster == goalCluster) {
+			int d = goalDistance[localIndex(goalCluster, current.cell)];
+			if (d != -1)
+				relax(goalNode, g + d, node, 0);
+		}
+
+		if (budget > 0 && (expansions & 31) == 0 &&
+			std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count() >= budget) {
+			partial = true;
+			end = closest;
+			break;
+		}
+	}
+	if (end == -1)
+		return -1;
+
+	//Walk the abstract path from the start, only the first segment is refined
+	path.clear();
+	for (int node = end; node != startNode; node = parent[node])
+		path.push_back(node);
+	for (auto node = path.rbegin(); node != path.rend(); ++node) {
+		int cell = *node == goalNode ? goal : nodes[*node].cell;
+		if (cell != start) {
+			firstStep = firstStepTowards(start, cell, segment);
+			break;
+		}
+	}
+	return gCost[end];
+}
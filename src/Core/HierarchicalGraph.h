@@ -0,0 +1,108 @@
+/**
+ * @file HierarchicalGraph.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the HierarchicalGraph class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "FlowField.h"
+
+#include <vector>
+
+/**
+ * @brief 	A node of the abstract graph, a cell next to the border of its cluster that
+ * 			connects to a cell in the neighbouring cluster.
+ */
+struct ClusterNode {
+	int					cell;		//y * width + x
+	int					cluster;
+	int					slot;		//position in the node list of its cluster
+	std::vector<int>	links;		//nodes on the other side of the border, 1 step away
+};
+
+/**
+ * @class HierarchicalGraph
+ * @brief 	Hierarchical pathfinding (HPA*) for very large levels. The map is split into
+ * 			square clusters, the entrances between neighbouring clusters become the nodes of
+ * 			an abstract graph and the cost between every pair of entrances of a cluster is
+ * 			precomputed. A query only searches the small abstract graph, and only the first
+ * 			segment of the path is refined to a step on the grid. Changing a wall only
+ * 			rebuilds the cluster it is in (and the neighbour, if it was on the border).
+ * 			A query that runs out of its time budget steps towards the closest entrance found.
+ */
+class HierarchicalGraph
+{
+public:
+	HierarchicalGraph(MazeGrid map, bool wrapHorizontal = true,
+					  int clusterSize = 16, int budgetMicroseconds = 0);
+
+	void build(unsigned int threadCount = 0);
+	void setWall(int y, int x, bool wall);
+	int  FindPath(int startY, int startX, int goalY, int goalX, FlowStep& firstStep,
+				  std::vector<FlowStep>* segment = nullptr);
+
+	inline void setBudget(int microseconds) { budget = microseconds; }
+	inline int  getNodeCount() const { return (int)nodes.size() - (int)freeNodes.size(); }
+	inline int  getClusterCount() const { return clustersX * clustersY; }
+	inline int  getLastExpansions() const { return expansions; }
+	inline bool wasLastPartial() const { return partial; }	//the last query ran out of budget
+
+private:
+	int height, width;
+	bool wrap;
+	int clusterSize;
+	int clustersX, clustersY;
+	int budget;			//microseconds per query, 0 for no limit
+	int expansions;		//abstract nodes popped by the last search
+	bool partial;
+
+	/**
+	 * @brief A pair of walkable cells facing each other across a cluster border.
+	 */
+	struct Transition {
+		int from, to;	//node ids, from is in the cluster owning the border
+	};
+
+	std::vector<unsigned char>	walkable;		//y * width + x -> 1 if the cell is not a wall
+	std::vector<int>			nodeOfCell;		//y * width + x -> node id, -1 if not a node
+	std::vector<ClusterNode>	nodes;
+	std::vector<int>			freeNodes;		//ids of removed nodes, reused first
+	std::vector<std::vector<int>> clusterNodes;	//cluster -> node ids
+	std::vector<std::vector<int>> intraCost;	//cluster -> k x k steps between its nodes, -1 if none
+	std::vector<std::vector<Transition>> borders;	//cluster * 2 + 0: right border, + 1: bottom border
+
+	//Abstract search scratch, stamped with a generation like the AStar class
+	struct OpenEntry {
+		int fCost;
+		int node;
+	};
+	std::vector<OpenEntry>		openList;
+	std::vector<unsigned int>	stamp;
+	std::vector<int>			gCost;
+	std::vector<int>			parent;
+	unsigned int				generation;
+	std::vector<int>			path;
+
+	//Breadth first searches inside the start and goal cluster
+	std::vector<int>			startDistance, goalDistance, clusterQueue;
+	std::vector<unsigned char>	startSteps;
+
+	int  clusterOf(int cell) const;
+	void clusterBounds(int cluster, int& y0, int& x0, int& y1, int& x1) const;
+	int  localIndex(int cluster, int cell) const;
+	int  heuristic(int cell, int goal) const;
+
+	int  addNode(int cell);
+	void unlink(int from, int to);
+	void makeBorder(int cluster, int side);
+	void makeCluster(int cluster, std::vector<int>& distance, std::vector<int>& queue);
+	void searchCluster(int cluster, int cell, std::vector<int>& distance,
+					   std::vector<unsigned char>* steps, std::vector<int>& queue) const;
+	void reserveScratch();
+	void relax(int node, int newCost, int from, int hCost);
+	FlowStep firstStepTowards(int start, int cell, std::vector<FlowStep>* segment = nullptr) const;
+};
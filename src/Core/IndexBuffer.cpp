@@ -9,7 +9,10 @@
  * 
  */
 #include "IndexBuffer.h"
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
+#include <vector>
 
 #include <GL/glew.h>
 
@@ -19,12 +22,10 @@
  * @param data 	- The data to be sent to the buffer
  * @param count - The amount of elements, not the total size in bytes.
  */
-IndexBuffer::IndexBuffer(const void* data, unsigned int count)
-	: m_count(count)
+IndexBuffer::IndexBuffer(const unsigned int* data, unsigned int count)
 {
 	glGenBuffers(1, &renderer_ID);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, renderer_ID);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW);
+	upload(data, count);
 }
 
 /**
@@ -62,8 +63,39 @@ void IndexBuffer::Unbind() const
  */
 void IndexBuffer::selectIndices(const unsigned int* data, unsigned int count)
 {
+	upload(data, count);
+}
+
+/**
+ * @brief 	Sends the indices to the buffer, as unsigned shorts when the largest of them fits
+ * 			in one, halving the memory and bandwidth they take.
+ *
+ * @param data	- The data to be sent to the buffer
+ * @param count - The amount of elements, not the total size in bytes.
+ */
+void IndexBuffer::upload(const unsigned int* data, unsigned int count)
+{
+	m_count = count;
 	Bind();
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(unsigned int), data, GL_STATIC_DRAW);
+	bool wide = data != nullptr && count > 0 && *std::max_element(data, data + count) > UINT16_MAX;
+	m_type = wide ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+	if (wide || data == nullptr)
+	{
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * getIndexSize(), data, GL_STATIC_DRAW);
+		return;
+	}
+
+	std::vector<uint16_t> narrow(data, data + count);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint16_t), narrow.data(), GL_STATIC_DRAW);
+}
+
+/**
+ * @brief The size of one index in the buffer, in bytes
+ *
+ */
+unsigned int IndexBuffer::getIndexSize() const
+{
+	return m_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(unsigned int);
 }
 
 /**
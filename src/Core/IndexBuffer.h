@@ -12,15 +12,19 @@
 
 /**
  * @class IndexBuffer
- * @brief Boilerplate OpenGL code regarding Element Array Buffers
+ * @brief 	Boilerplate OpenGL code regarding Element Array Buffers. The indices are given as
+ * 			unsigned ints, and stored as unsigned shorts on the gpu when they all fit in one.
  */
 class IndexBuffer
 {
 private:
 	unsigned int renderer_ID;
 	unsigned int m_count;
+	unsigned int m_type;	//GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+
+	void upload(const unsigned int* data, unsigned int count);
 public:
-	IndexBuffer(const void* data, unsigned int count);
+	IndexBuffer(const unsigned int* data, unsigned int count);
 	~IndexBuffer();
 
 	void Bind() const;
@@ -30,5 +34,7 @@ public:
 
 	void deleteBuffer();
 	inline unsigned int getCount() const { return m_count; }
+	inline unsigned int getType() const { return m_type; }
+	unsigned int getIndexSize() const;	//in bytes, for offsets into the buffer
 };
 
@@ -0,0 +1,362 @@
+/**
+ * @file JunctionGraph.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class contracting the corridors of the maze into a graph of junctions.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "JunctionGraph.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+
+namespace {
+	const int offsetY[4] = { -1, 1, 0, 0 }; //same order as FlowStep
+	const int offsetX[4] = { 0, 0, -1, 1 };
+	const unsigned char opposite[4] = { StepDown, StepUp, StepRight, StepLeft };
+
+	/**
+	 * @brief Comparison used for the open list, the cheapest entry is on top of the heap.
+	 */
+	struct CompareCost {
+		template<typename T>
+		bool operator()(T const& e1, T const& e2) const { return e1.cost > e2.cost; }
+	};
+}
+
+/**
+ * @brief Construct a new JunctionGraph::JunctionGraph object, contracting the map.
+ *
+ * @param map 				- The 2d grid of the maze
+ * @param wrapHorizontal 	- Wheter or not walking off the left/right edge enters on the other side,
+ * 							  ignored for levels 2 or less wide where the tunnel leads to a cell that
+ * 							  is already a neighbour (or the cell itself) and would be counted twice
+ */
+JunctionGraph::JunctionGraph(MazeGrid map, bool wrapHorizontal)
+	:	height(map.getHeight()),
+		width(map.getWidth()),
+		wrap(wrapHorizontal && map.getWidth() > 2),
+		nodeCount(0),
+		expansions(0),
+		generation(0)
+{
+	makeNodes(map);
+	makeAdjacency();
+
+	stamp.assign(nodeCount, 0);
+	cost.assign(nodeCount, 0);
+	firstStepOf.assign(nodeCount, StepNone);
+	openList.reserve(nodeCount);
+}
+
+/**
+ * @brief Finds the walkable neighbour of a cell in a given direction.
+ *
+ * @param index 	- y * width + x of the cell
+ * @param direction - FlowStep to take
+ * @return int 		- y * width + x of the neighbour, -1 if it is a wall or outside the map
+ */
+int JunctionGraph::neighbour(int index, int direction) const
+{
+	int y = index / width + offsetY[direction];
+	int x = index % width + offsetX[direction];
+	if (wrap)	//the tunnel
+		x = (x + width) % width;
+	if (y < 0 || y >= height || x < 0 || x >= width || !walkable[y * width + x])
+		return -1;
+	return y * width + x;
+}
+
+/**
+ * @brief Makes a cell a node of the graph.
+ *
+ * @param index - y * width + x of the cell
+ */
+void JunctionGraph::addNode(int index)
+{
+	nodeOfCell[index] = nodeCount++;
+	nodeCell.push_back(index);
+}
+
+/**
+ * @brief 	Every walkable cell that does not have exactly two walkable neighbours
+ * 			(junctions and dead ends) becomes a node, the rest become corridor cells.
+ *
+ * @param map - The 2d grid of the maze
+ */
+void JunctionGraph::makeNodes(MazeGrid map)
+{
+	int cells = height * width;
+	walkable.assign(cells, 0);
+	nodeOfCell.assign(cells, -1);
+	edgeOfCell.assign(cells, -1);
+	offsetOfCell.assign(cells, 0);
+	stepsOfCell.assign(cells, 0);
+
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++)
+			walkable[y * width + x] = map(y, x) != 1;
+
+	for (int i = 0; i < cells; i++) {
+		if (!walkable[i])
+			continue;
+		int degree = 0;
+		for (int d = 0; d < 4; d++)
+			if (neighbour(i, d) != -1)
+				degree++;
+		if (degree != 2)
+			addNode(i);
+	}
+
+	for (int node = 0; node < nodeCount; node++)
+		for (int d = 0; d < 4; d++)
+			walkCorridor(node, d);
+
+	//Loops without any junction are left over, one cell of each becomes a node
+	for (int i = 0; i < cells; i++)
+		if (walkable[i] && nodeOfCell[i] == -1 && edgeOfCell[i] == -1) {
+			addNode(i);
+			for (int d = 0; d < 4; d++)
+				walkCorridor(nodeCount - 1, d);
+		}
+}
+
+/**
+ * @brief 	Walks from a node along the corridor in a given direction until it reaches
+ * 			another node, and adds the corridor as an edge. Corridors already walked
+ * 			from their other end are skipped.
+ *
+ * @param node 		- The node to walk from
+ * @param direction - The FlowStep to leave the node in
+ */
+void JunctionGraph::walkCorridor(int node, int direction)
+{
+	int start = nodeCell[node];
+	int cell = neighbour(start, direction);
+	if (cell == -1 || edgeOfCell[cell] != -1)
+		return;
+
+	if (nodeOfCell[cell] != -1) { //two nodes next to each other, added once
+		if (node < nodeOfCell[cell])
+			edges.push_back({ node, nodeOfCell[cell], 1, (unsigned char)direction, opposite[direction] });
+		return;
+	}
+
+	int edge = edges.size();
+	JunctionEdge corridor = { node, -1, 0, (unsigned char)direction, StepNone };
+
+	int previous = start;
+	unsigned char backStep = opposite[direction];
+	int length = 1;
+	while (true) {
+		edgeOfCell[cell] = edge;
+		offsetOfCell[cell] = length;
+		stepsOfCell[cell] = backStep;
+
+		//A corridor cell has exactly two neighbours, continue to the one we did not come from
+		int next = -1, nextStep = 0;
+		for (int d = 0; d < 4; d++) {
+			int n = neighbour(cell, d);
+			if (n != -1 && n != previous) {
+				next = n;
+				nextStep = d;
+				break;
+			}
+		}
+		stepsOfCell[cell] |= nextStep << 2;
+
+		length++;
+		if (nodeOfCell[next] != -1) {
+			corridor.to = nodeOfCell[next];
+			corridor.length = length;
+			corridor.stepFromTo = opposite[nextStep];
+			break;
+		}
+		previous = cell;
+		cell = next;
+		backStep = opposite[nextStep];
+	}
+	edges.push_back(corridor);
+}
+
+/**
+ * @brief Builds the list of edges touching every node.
+ *
+ */
+void JunctionGraph::makeAdjacency()
+{
+	adjacencyStart.assign(nodeCount + 1, 0);
+	for (const auto& edge : edges) {
+		adjacencyStart[edge.from + 1]++;
+		if (edge.to != edge.from)
+			adjacencyStart[edge.to + 1]++;
+	}
+	for (int node = 0; node < nodeCount; node++)
+		adjacencyStart[node + 1] += adjacencyStart[node];
+
+	std::vector<int> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+	adjacency.resize(adjacencyStart[nodeCount]);
+	for (int e = 0; e < (int)edges.size(); e++) {
+		adjacency[fill[edges[e].from]++] = e;
+		if (edges[e].to != edges[e].from)
+			adjacency[fill[edges[e].to]++] = e;
+	}
+}
+
+/**
+ * @brief Maps a grid position to the corridor it is in.
+ *
+ * @param y 		- The y coordinate of the cell
+ * @param x 		- The x coordinate of the cell
+ * @param edge 		- Is set to the edge the cell belongs to
+ * @param offset 	- Is set to the amount of steps from the from node of the edge
+ * @return true 	- The cell is a corridor cell
+ * @return false 	- The cell is a node or a wall
+ */
+bool JunctionGraph::locate(int y, int x, int& edge, int& offset) const
+{
+	if (y < 0 || y >= height || x < 0 || x >= width || edgeOfCell[y * width + x] == -1)
+		return false;
+	edge = edgeOfCell[y * width + x];
+	offset = offsetOfCell[y * width + x];
+	return true;
+}
+
+/**
+ * @brief 	Manhattan distance from a node to the goal, taking the tunnel into account. A
+ * 			corridor is never shorter than the distance between its ends, so the estimate
+ * 			never decreases by more than the length of an edge.
+ *
+ * @param node 	- The node
+ * @param goal 	- y * width + x of the goal
+ * @return int 	- The estimated steps left
+ */
+int JunctionGraph::heuristic(int node, int goal) const
+{
+	int dx = abs(nodeCell[node] % width - goal % width);
+	if (wrap)
+		dx = std::min(dx, width - dx);
+	return abs(nodeCell[node] / width - goal / width) + dx;
+}
+
+/**
+ * @brief Updates the cost of a node if the new cost is lower, and adds it to the open list.
+ *
+ * @param node 		- The node reached
+ * @param newCost 	- The cost of reaching it
+ * @param step 		- The first step taken from the start to get here
+ * @param goal 		- y * width + x of the goal
+ */
+void JunctionGraph::relax(int node, int newCost, unsigned char step, int goal)
+{
+	if (stamp[node] < generation || (stamp[node] == generation && newCost < cost[node])) {
+		stamp[node] = generation;
+		cost[node] = newCost;
+		firstStepOf[node] = step;
+		openList.push_back({ newCost + heuristic(node, goal), node });
+		std::push_heap(openList.begin(), openList.end(), CompareCost());
+	}
+}
+
+/**
+ * @brief 	Finds the shortest path between two cells by running A* on the graph.
+ * 			A start or goal inside a corridor enters the graph at both ends of its edge.
+ *
+ * @param startY 	- The y coordinate of the start
+ * @param startX 	- The x coordinate of the start
+ * @param goalY 	- The y coordinate of the goal
+ * @param goalX 	- The x coordinate of the goal
+ * @param firstStep - Is set to the first step along the path
+ * @return int 		- The length of the path, 0 if start is the goal and -1 if there is no path
+ */
+int JunctionGraph::FindPath(int startY, int startX, int goalY, int goalX, FlowStep& firstStep)
+{
+	expansions = 0;
+	firstStep = StepNone;
+	if (startY < 0 || startY >= height || startX < 0 || startX >= width ||
+		goalY < 0 || goalY >= height || goalX < 0 || goalX >= width)
+		return -1;
+
+	int start = startY * width + startX;
+	int goal = goalY * width + goalX;
+	if (!walkable[start] || !walkable[goal])
+		return -1;
+	if (start == goal)
+		return 0;
+
+	generation += 2; //generation: discovered, generation + 1: closed
+	if (generation < 2) {
+		std::fill(stamp.begin(), stamp.end(), 0u);
+		generation = 2;
+	}
+	openList.clear();
+
+	int best = INT_MAX;
+	unsigned char bestStep = StepNone;
+
+	//The nodes the goal can be reached from, with the extra cost and the step into the corridor
+	struct Target { int node, extra; unsigned char step; } targets[2];
+	int targetCount = 0;
+	if (nodeOfCell[goal] != -1)
+		targets[targetCount++] = { nodeOfCell[goal], 0, StepNone };
+	else {
+		const JunctionEdge& edge = edges[edgeOfCell[goal]];
+		targets[targetCount++] = { edge.from, offsetOfCell[goal], edge.stepFromFrom };
+		targets[targetCount++] = { edge.to, edge.length - offsetOfCell[goal], edge.stepFromTo };
+	}
+
+	if (nodeOfCell[start] != -1)
+		relax(nodeOfCell[start], 0, StepNone, goal);
+	else {
+		const JunctionEdge& edge = edges[edgeOfCell[start]];
+		int offset = offsetOfCell[start];
+		unsigned char towardsFrom = stepsOfCell[start] & 3;
+		unsigned char towardsTo = stepsOfCell[start] >> 2;
+		if (edgeOfCell[goal] == edgeOfCell[start]) { //same corridor, walk straight there
+			best = abs(offsetOfCell[goal] - offset);
+			bestStep = offsetOfCell[goal] < offset ? towardsFrom : towardsTo;
+		}
+		relax(edge.from, offset, towardsFrom, goal);
+		relax(edge.to, edge.length - offset, towardsTo, goal);
+	}
+
+	while (!openList.empty()) {
+		std::pop_heap(openList.begin(), openList.end(), CompareCost());
+		OpenEntry entry = openList.back();
+		openList.pop_back();
+
+		int node = entry.node;
+		if (stamp[node] == generation + 1 || entry.cost != cost[node] + heuristic(node, goal)) //stale entry
+			continue;
+		if (entry.cost >= best)	//the heuristic never overestimates, nothing left can be shorter
+			break;
+		stamp[node] = generation + 1;
+		expansions++;
+
+		for (int t = 0; t < targetCount; t++)
+			if (targets[t].node == node && cost[node] + targets[t].extra < best) {
+				best = cost[node] + targets[t].extra;
+				bestStep = firstStepOf[node] != StepNone ? firstStepOf[node] : targets[t].step;
+			}
+
+		for (int a = adjacencyStart[node]; a < adjacencyStart[node + 1]; a++) {
+			const JunctionEdge& edge = edges[adjacency[a]];
+			if (edge.from == edge.to) //a loop back to the same node never helps
+				continue;
+			int other = edge.from == node ? edge.to : edge.from;
+			unsigned char step = firstStepOf[node];
+			if (step == StepNone) //leaving the start node
+				step = edge.from == node ? edge.stepFromFrom : edge.stepFromTo;
+			relax(other, cost[node] + edge.length, step, goal);
+		}
+	}
+
+	if (best == INT_MAX)
+		return -1;
+	firstStep = (FlowStep)bestStep;
+	return best;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file JunctionGraph.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the JunctionGraph class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "FlowField.h"
+
+#include <vector>
+
+/**
+ * @brief 	A corridor between two graph nodes. The cells of the corridor are not nodes,
+ * 			they only remember which edge they belong to and how far along it they are.
+ */
+struct JunctionEdge {
+	int				from,
+					to,
+					length;		//steps from the from node to the to node
+	unsigned char	stepFromFrom,	//FlowStep taken from the from node into the corridor
+					stepFromTo;		//FlowStep taken from the to node into the corridor
+};
+
+/**
+ * @class JunctionGraph
+ * @brief 	The maze contracted to a weighted graph. Junctions and dead ends are nodes,
+ * 			the 1 wide corridors between them are edges weighted by their length. Searches
+ * 			(A* with the manhattan distance) run on the graph instead of on the grid, so the
+ * 			many corridor cells that give the search no new choices are never expanded.
+ */
+class JunctionGraph
+{
+public:
+	JunctionGraph(MazeGrid map, bool wrapHorizontal = true);
+
+	int  FindPath(int startY, int startX, int goalY, int goalX, FlowStep& firstStep);
+	bool locate(int y, int x, int& edge, int& offset) const;
+
+	inline int getNodeCount() const { return nodeCount; }
+	inline int getEdgeCount() const { return edges.size(); }
+	inline const JunctionEdge& getEdge(int edge) const { return edges[edge]; }
+	inline int getLastExpansions() const { return expansions; }
+
+private:
+	int height, width;
+	bool wrap;
+	int nodeCount;
+	int expansions;		//nodes popped by the last search
+
+	std::vector<unsigned char> walkable;	//y * width + x -> 1 if the cell is not a wall
+	std::vector<int> nodeCell;		//node id -> y * width + x
+	std::vector<int> nodeOfCell;	//y * width + x -> node id, -1 if not a node
+	std::vector<int> edgeOfCell;	//y * width + x -> edge id for corridor cells, -1 otherwise
+	std::vector<int> offsetOfCell;	//steps from the from node of the edge
+	std::vector<unsigned char> stepsOfCell;	//corridor cells: towards from node | towards to node << 2
+
+	std::vector<JunctionEdge> edges;
+	std::vector<int> adjacencyStart;	//node -> first entry in adjacency, nodeCount + 1 long
+	std::vector<int> adjacency;			//edge ids
+
+	//Search scratch, stamped with a generation like the AStar class
+	struct OpenEntry {
+		int cost;	//cost from the start plus the heuristic
+		int node;
+	};
+	std::vector<OpenEntry>		openList;
+	std::vector<unsigned int>	stamp;
+	std::vector<int>			cost;
+	std::vector<unsigned char>	firstStepOf;
+	unsigned int				generation;
+
+	int  neighbour(int index, int direction) const;
+	int  heuristic(int node, int goal) const;
+	void makeNodes(MazeGrid map);
+	void addNode(int index);
+	void walkCorridor(int node, int direction);
+	void makeAdjacency();
+	void relax(int node, int newCost, unsigned char step, int goal);
+};
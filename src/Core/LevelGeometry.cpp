@@ -0,0 +1,263 @@
+/**
+ * @file LevelGeometry.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief The geometry of the mazes and the pellets, generated from the tiles of a level.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "LevelGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace {
+	/**
+	 * @brief A corner of a side of a wall, relative to the tile.
+	 */
+	struct FaceCorner {
+		glm::ivec3 position;
+		glm::ivec2 textureCoord;
+	};
+
+	//The sides of a wall: right, left, back and front, in the order of MazeFace.
+	const FaceCorner WALL_FACES[4][4] = {
+		{ { { 1, 0, 1 }, { 0, 0 } }, { { 1, 0, 0 }, { 1, 0 } }, { { 1, 1, 1 }, { 0, 1 } }, { { 1, 1, 0 }, { 1, 1 } } },
+		{ { { 0, 0, 0 }, { 0, 0 } }, { { 0, 0, 1 }, { 1, 0 } }, { { 0, 1, 0 }, { 0, 1 } }, { { 0, 1, 1 }, { 1, 1 } } },
+		{ { { 1, 0, 0 }, { 0, 0 } }, { { 0, 0, 0 }, { 1, 0 } }, { { 1, 1, 0 }, { 0, 1 } }, { { 0, 1, 0 }, { 1, 1 } } },
+		{ { { 0, 0, 1 }, { 0, 0 } }, { { 1, 0, 1 }, { 1, 0 } }, { { 0, 1, 1 }, { 0, 1 } }, { { 1, 1, 1 }, { 1, 1 } } }
+	};
+	const int WALL_NEIGHBOUR_X[4] = { 1, -1, 0, 0 };
+	const int WALL_NEIGHBOUR_Z[4] = { 0, 0, -1, 1 };
+
+	/**
+	 * @brief Packs a corner of the 3d maze.
+	 *
+	 * @param x 	- The x coordinate of the corner, at least -VERTEX_OFFSET
+	 * @param z 	- The z coordinate of the corner, at least -VERTEX_OFFSET
+	 * @param u 	- The texture coordinate along the face
+	 * @param v 	- The texture coordinate across the face, 0 or 1
+	 * @param face 	- The face the corner belongs to
+	 */
+	Vertex packVertex(int x, int z, int u, int v, MazeFace face)
+	{
+		Vertex vertex;
+		vertex.x = (uint16_t)(x + VERTEX_OFFSET);
+		vertex.z = (uint16_t)(z + VERTEX_OFFSET);
+		vertex.u = (uint16_t)u;
+		vertex.bits = (uint16_t)(v | (uint16_t)face << 1);
+		return vertex;
+	}
+
+	/**
+	 * @brief 	Adds the sides of the walls in [firstX, lastX) x [firstZ, lastZ) that face a tile
+	 * 			that is not a wall. The sides facing along x are merged into runs along z,
+	 * 			the ones facing along z into runs along x.
+	 *
+	 * @param first 	- The vertex the indices count from
+	 */
+	void addWalls(MazeGrid grid, int firstX, int firstZ, int lastX, int lastZ,
+				  unsigned int first, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+	{
+		auto exposed = [grid](int x, int z, int face) {
+			int neighbourX = x + WALL_NEIGHBOUR_X[face];
+			int neighbourZ = z + WALL_NEIGHBOUR_Z[face];
+			return grid.isWall(z, x) && grid.contains(neighbourZ, neighbourX) && !grid.isWall(neighbourZ, neighbourX);
+		};
+
+		for (int face = 0; face < 4; face++) {
+			bool alongZ = WALL_NEIGHBOUR_X[face] != 0;
+			int rows = alongZ ? lastX - firstX : lastZ - firstZ;
+			int length = alongZ ? lastZ - firstZ : lastX - firstX;
+			for (int row = 0; row < rows; row++)
+				for (int i = 0; i < length;) {
+					int x = alongZ ? firstX + row : firstX + i;
+					int z = alongZ ? firstZ + i : firstZ + row;
+					if (!exposed(x, z, face)) {
+						i++;
+						continue;
+					}
+					int run = 1;
+					while (i + run < length && exposed(alongZ ? x : x + run, alongZ ? z + run : z, face))
+						run++;
+
+					unsigned int k = (unsigned int)vertices.size() - first;
+					for (const auto& corner : WALL_FACES[face]) {
+						glm::ivec3 offset = corner.position;
+						if (alongZ)
+							offset.z *= run;
+						else
+							offset.x *= run;
+						vertices.push_back(packVertex(x + offset.x, z + offset.z, corner.textureCoord.x * run,
+													  corner.textureCoord.y, (MazeFace)face));
+					}
+					for (unsigned int corner : { 0, 1, 2, 1, 2, 3 })
+						indices.push_back(k + corner);
+					i += run;
+				}
+		}
+	}
+}
+
+/**
+ * @brief 	Generates the floor under the 3d maze, two tiles larger than the level on every
+ * 			side to make sure it covers it all.
+ *
+ * @param width 	- The width of the level
+ * @param height 	- The height of the level
+ * @param vertices 	- The four corners are added to it
+ * @param indices 	- The two triangles are added to it
+ */
+void makeMazeFloor(int width, int height, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	unsigned int first = (unsigned int)vertices.size();
+	//Plane / Floor for the maze, maze.vs puts it just below the walls:
+	vertices.push_back(packVertex(-2, -2, 0, 0, MazeFace::Floor));
+	vertices.push_back(packVertex(width + 2, -2, 1, 0, MazeFace::Floor));
+	vertices.push_back(packVertex(-2, height + 2, 0, 1, MazeFace::Floor));
+	vertices.push_back(packVertex(width + 2, height + 2, 1, 1, MazeFace::Floor));
+
+	for (unsigned int corner : { 0, 1, 2, 1, 2, 3 })
+		indices.push_back(first + corner);
+}
+
+/**
+ * @brief 	Generates the 3d maze: the floor, and the sides of the walls facing a tile that
+ * 			is not a wall. Sides next to each other in the same plane are merged into one
+ * 			quad, with the texture repeating once per tile along it. The walls are laid out
+ * 			chunk by chunk (MESH_CHUNK_SIZE tiles square) after the six indices of the floor,
+ * 			the merging stops at the edge of a chunk.
+ *
+ * @param grid 		- The tiles of the level
+ * @param vertices 	- The vertices are added to it
+ * @param indices 	- The indices are added to it
+ * @param chunks 	- The chunks with any walls are added to it
+ */
+void makeMazeMesh(MazeGrid grid, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+				  std::vector<MeshChunk>& chunks)
+{
+	int width = grid.getWidth(), height = grid.getHeight();
+	makeMazeFloor(width, height, vertices, indices);
+	for (int z = 0; z < height; z += MESH_CHUNK_SIZE)
+		for (int x = 0; x < width; x += MESH_CHUNK_SIZE) {
+			MeshChunk chunk;
+			chunk.firstIndex = (uint32_t)indices.size();
+			addWalls(grid, x, z, std::min(x + MESH_CHUNK_SIZE, width), std::min(z + MESH_CHUNK_SIZE, height),
+					 0, vertices, indices);
+			chunk.indexCount = (uint32_t)indices.size() - chunk.firstIndex;
+			chunk.min = glm::vec3(x, 0, z);
+			chunk.max = glm::vec3(std::min(x + MESH_CHUNK_SIZE, width), 1, std::min(z + MESH_CHUNK_SIZE, height));
+			if (chunk.indexCount > 0)
+				chunks.push_back(chunk);
+		}
+}
+
+/**
+ * @brief 	Generates the walls in one chunk of the 3d maze, for streaming levels too large
+ * 			to mesh as a whole. The sides are merged like makeMazeMesh does, up to the edge
+ * 			of the chunk.
+ *
+ * @param grid 		- The tiles of the level
+ * @param firstX 	- The x coordinate of the first tile of the chunk
+ * @param firstZ 	- The z (y in the level) coordinate of the first tile of the chunk
+ * @param size 		- The width and height of the chunk in tiles, cut at the edge of the level
+ * @param vertices 	- The vertices are added to it
+ * @param indices 	- The indices are added to it, counting from the first vertex added
+ */
+void makeMazeChunk(MazeGrid grid, int firstX, int firstZ, int size,
+				   std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+{
+	addWalls(grid, firstX, firstZ, std::min(firstX + size, grid.getWidth()), std::min(firstZ + size, grid.getHeight()),
+			 (unsigned int)vertices.size(), vertices, indices);
+}
+
+/**
+ * @brief 	Gives the tiles the minimap shows: the whole level, or on streamed levels the
+ * 			MINIMAP_WINDOW_SIDE tiles around the player. The window moves in steps of a
+ * 			quarter of its side, so its meshes are only rebuilt now and then, with the
+ * 			player kept near the centre.
+ *
+ * @param width 			- The width of the level
+ * @param height 			- The height of the level
+ * @param x 				- The x coordinate of the player
+ * @param y 				- The y coordinate (z in the 3d maze) of the player
+ * @return MinimapWindow 	- The tiles to show
+ */
+MinimapWindow makeMinimapWindow(int width, int height, float x, float y)
+{
+	if (!isStreamedLevel(width, height))
+		return { 0, 0, width, height };
+
+	const int step = MINIMAP_WINDOW_SIDE / 4;
+	MinimapWindow window = { 0, 0, std::min(width, MINIMAP_WINDOW_SIDE), std::min(height, MINIMAP_WINDOW_SIDE) };
+	window.x = (int)std::floor(x / step) * step - (window.width - step) / 2;
+	window.y = (int)std::floor(y / step) * step - (window.height - step) / 2;
+	window.x = std::max(0, std::min(window.x, width - window.width));
+	window.y = std::max(0, std::min(window.y, height - window.height));
+	return window;
+}
+
+/**
+ * @brief Generates the corners of every tile of the window of the 2d maze (the minimap).
+ *
+ * @param window 	- The tiles the minimap shows
+ * @param positions - The positions are added to it
+ */
+void makeMinimapPositions(MinimapWindow window, std::vector<glm::vec3>& positions)
+{
+	for (int y = window.y; y < window.y + window.height + 1; y++) {
+		for (int x = window.x; x < window.x + window.width + 1; x++) {
+			positions.push_back(glm::vec3(x, y, 0));
+		}
+	}
+}
+
+/**
+ * @brief Generates the indices for each wall of the window of the 2d maze (the minimap).
+ *
+ * @param grid 		- The tiles of the level
+ * @param window 	- The tiles the minimap shows
+ * @param indices 	- The indices are added to it
+ */
+void makeMinimapIndices(MazeGrid grid, MinimapWindow window, std::vector<unsigned int>& indices)
+{
+	int width = window.width, height = window.height;
+	auto getTile = [grid, window](int y, int x) { return grid(window.y + y, window.x + x); };
+
+	//Since we require +1 more indices than the amount of squares it is incremented.
+	int indicesHeigth = height + 1; int indicesWidth = width + 1;
+
+	for (int i = 0; i < indicesHeigth; i++) {
+		for (int j = 0; j < indicesWidth; j++) {
+			if (i < height && j < width && getTile(i, j) == 1) {
+						indices.push_back((i * indicesWidth) + j);
+						indices.push_back((i * indicesWidth) + j + 1);
+						indices.push_back(((i + 1) * indicesWidth) + j);
+
+						indices.push_back((i * indicesWidth) + j + 1);
+						indices.push_back(((i + 1) * indicesWidth) + j);
+						indices.push_back(((i + 1) * indicesWidth) + (j + 1));
+			}
+		}
+	}
+}
+
+/**
+ * @brief Returns the model matrix of the pellet on a tile.
+ *
+ * @param x 			- The x coordinate of the tile
+ * @param y 			- The y coordinate of the tile
+ * @return glm::mat4 	- The model matrix for the instanced pellets
+ */
+glm::mat4 makePelletMatrix(int x, int y)
+{
+	glm::mat4 translation = glm::translate(glm::mat4(1), glm::vec3(x + .5f, 0, y + .5f));
+	glm::mat4 rotation = glm::rotate(glm::mat4(1), glm::radians(1 * 25.f), glm::vec3(0, 1, 0));
+	glm::mat4 scale = glm::scale(glm::mat4(1), glm::vec3(0.1f));
+
+	return translation * rotation * scale;
+}
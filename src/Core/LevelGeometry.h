@@ -0,0 +1,88 @@
+/**
+ * @file LevelGeometry.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Functions generating the geometry of the mazes and the pellets.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "MazeGrid.h"
+
+/**
+ * @brief 	The faces of the 3d maze, what a Vertex points out of.
+ */
+enum class MazeFace : uint16_t {
+	Right = 0,
+	Left  = 1,
+	Back  = 2,
+	Front = 3,
+	Floor = 4
+};
+
+const int VERTEX_OFFSET = 2;	//added to x and z of a Vertex, the floor reaches two tiles outside of the level
+
+/**
+ * @brief 	A vertex of the 3d maze packed into 8 bytes, the corners of the maze all lie on
+ * 			whole tiles and the faces along the axes. maze.vs unpacks it into the position,
+ * 			normal and texture coordinate.
+ */
+struct Vertex {
+	uint16_t x,
+			 z;		//the position plus VERTEX_OFFSET
+	uint16_t u;		//the texture coordinate along the face, once per tile along a wall
+	uint16_t bits;	//bit 0: the texture coordinate v, for a wall also its height; bits 1-3: the MazeFace
+};
+static_assert(sizeof(Vertex) == 8, "the maze vertices have to stay packed");
+//The floor reaches VERTEX_OFFSET tiles past the far edges as well, the largest level ScenarioLoader accepts still fits x and z
+static_assert(MAX_LEVEL_SIDE + 2 * VERTEX_OFFSET <= UINT16_MAX, "the levels are too large for the packed vertices");
+
+/**
+ * @brief 	A square of tiles of the 3d maze with its own range of the index buffer and its
+ * 			bounding box, so the ones outside of the view can be skipped.
+ */
+struct MeshChunk {
+	uint32_t firstIndex,
+			 indexCount;
+	glm::vec3 min,
+			  max;
+};
+
+const int MESH_CHUNK_SIZE = 8;	//tiles along each side of a MeshChunk
+
+//Levels with at least this many tiles are not meshed as a whole, Maze3D streams them in chunks around the camera
+const int STREAMING_MIN_CELLS = 512 * 512;
+
+inline bool isStreamedLevel(int width, int height) { return (long long)width * height >= STREAMING_MIN_CELLS; }
+
+const int MINIMAP_WINDOW_SIDE = 128;	//tiles the minimap shows along each side of a streamed level
+
+/**
+ * @brief The tiles the minimap shows, the whole level unless it is streamed.
+ *
+ */
+struct MinimapWindow {
+	int x,		//the first tile
+		y,
+		width,
+		height;
+
+	inline bool operator==(const MinimapWindow& other) const { return x == other.x && y == other.y && width == other.width && height == other.height; }
+};
+
+//Kept free of OpenGL, so levelc can precompute the same buffers the game uploads
+void makeMazeFloor(int width, int height, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+void makeMazeMesh(MazeGrid grid, std::vector<Vertex>& vertices, std::vector<unsigned int>& indices,
+				  std::vector<MeshChunk>& chunks);
+void makeMazeChunk(MazeGrid grid, int firstX, int firstZ, int size,
+				   std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+MinimapWindow makeMinimapWindow(int width, int height, float x, float y);
+void makeMinimapPositions(MinimapWindow window, std::vector<glm::vec3>& positions);
+void makeMinimapIndices(MazeGrid grid, MinimapWindow window, std::vector<unsigned int>& indices);
+glm::mat4 makePelletMatrix(int x, int y);
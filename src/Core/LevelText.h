@@ -0,0 +1,165 @@
+/**
+ * @file LevelText.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Parsing and checking of level files at compile time, for the levels embedded into the executable.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "ScenarioLoader.h"
+
+#include <cstdint>
+
+/**
+ * @brief 	constexpr versions of what ScenarioLoader and GameSim do with a level file, so an
+ * 			embedded level is turned into tiles by the compiler and a broken one fails the
+ * 			build (static_assert in the generated EmbeddedAssetData.inc) instead of the game.
+ * 			The text is null terminated and laid out like ScenarioLoader expects.
+ */
+namespace LevelText {
+	const int MAX_SIDE = MAX_LEVEL_SIDE;	//same limit as ScenarioLoader
+
+	constexpr bool isDigit(char c) { return c >= '0' && c <= '9'; }
+	constexpr bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+	/**
+	 * @brief Reads a whole number, i is left after its last digit.
+	 *
+	 * @return int - The number, -1 if there is none or it is larger than the limit
+	 */
+	constexpr int readNumber(const char* text, int& i, int limit)
+	{
+		if (!isDigit(text[i]))
+			return -1;
+		int value = 0;
+		while (isDigit(text[i])) {
+			value = value * 10 + (text[i++] - '0');
+			if (value > limit)
+				return -1;
+		}
+		return value;
+	}
+
+	/**
+	 * @brief Reads "<width>x<height>" from the first line.
+	 *
+	 * @param size 	- 0 for the width, 1 for the height
+	 * @return int 	- The width or height, 0 if the line is broken
+	 */
+	constexpr int readSize(const char* text, int size)
+	{
+		int i = 0;
+		while (isBlank(text[i]))
+			i++;
+		int width = readNumber(text, i, MAX_SIDE);
+		if (width <= 0 || (text[i] != 'x' && text[i] != 'X'))
+			return 0;
+		i++;
+		int height = readNumber(text, i, MAX_SIDE);
+		while (isBlank(text[i]))
+			i++;
+		if (height <= 0 || (text[i] != '\n' && text[i] != '\0'))
+			return 0;
+		return size == 0 ? width : height;
+	}
+
+	/**
+	 * @brief The amount of tiles, at least 1 so a broken level still gets a valid array type.
+	 *
+	 */
+	constexpr int tileCount(const char* text)
+	{
+		return readSize(text, 0) * readSize(text, 1) > 0 ? readSize(text, 0) * readSize(text, 1) : 1;
+	}
+
+	/**
+	 * @brief A parsed level, one byte per tile row by row like the MazeGrid of a ScenarioLoader.
+	 *
+	 */
+	template <int Tiles>
+	struct Level {
+		int width, height;
+		bool valid;			//every row has width values and there are height rows
+		uint8_t tiles[Tiles];
+	};
+
+	/**
+	 * @brief Parses the level.
+	 *
+	 * @tparam Tiles 			- tileCount(text)
+	 * @return Level<Tiles> 	- The level, valid is false if the rows do not match the size
+	 */
+	template <int Tiles>
+	constexpr Level<Tiles> parse(const char* text)
+	{
+		Level<Tiles> level{};
+		level.width = readSize(text, 0);
+		level.height = readSize(text, 1);
+		if (level.width * level.height != Tiles)
+			return level;
+
+		int i = 0;
+		while (text[i] != '\n' && text[i] != '\0')
+			i++;
+		for (int y = 0; y < level.height; y++) {
+			if (text[i] != '\n')
+				return level;
+			i++;
+			for (int x = 0; x < level.width; x++) {
+				while (isBlank(text[i]))
+					i++;
+				int value = readNumber(text, i, 255);
+				if (value < 0 || (text[i] != '\n' && text[i] != '\0' && !isBlank(text[i])))
+					return level;
+				level.tiles[y * level.width + x] = (uint8_t)value;
+			}
+			while (isBlank(text[i]))
+				i++;
+		}
+
+		//Only empty lines may follow the last row
+		while (text[i] == '\n' || isBlank(text[i]))
+			i++;
+		level.valid = text[i] == '\0';
+		return level;
+	}
+
+	/**
+	 * @brief Counts the tiles with a value.
+	 *
+	 */
+	template <int Tiles>
+	constexpr int count(const Level<Tiles>& level, int value)
+	{
+		int found = 0;
+		for (int i = 0; i < Tiles; i++)
+			if (level.tiles[i] == value)
+				found++;
+		return found;
+	}
+
+	/**
+	 * @brief 	Checks the ghost spawns: ghost i is placed on the tile with the ID 3 + i, so
+	 * 			every ID from 3 up to the highest one has to be on exactly one tile.
+	 *
+	 * @return true - The spawns are valid
+	 */
+	template <int Tiles>
+	constexpr bool ghostsPlacedOnce(const Level<Tiles>& level)
+	{
+		int counts[256] = {};
+		int highest = 0;
+		for (int i = 0; i < Tiles; i++) {
+			counts[level.tiles[i]]++;
+			if (level.tiles[i] != EMPTY_TILE && level.tiles[i] > highest)
+				highest = level.tiles[i];
+		}
+		for (int id = 3; id <= highest; id++)
+			if (counts[id] != 1)
+				return false;
+		return true;
+	}
+}
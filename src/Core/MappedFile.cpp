@@ -0,0 +1,109 @@
+/**
+ * @file MappedFile.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class mapping a whole file into memory.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "MappedFile.h"
+
+#include <cstdint>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief Construct a new MappedFile::MappedFile object, mapping the whole file.
+ *
+ * @param filepath - The file to map, isOpen() is false if it can not be opened
+ */
+MappedFile::MappedFile(const std::string& filepath)
+	:	data(nullptr),
+		size(0),
+		opened(false),
+		file(nullptr),
+		mapping(nullptr)
+{
+#ifdef _WIN32
+	HANDLE handle = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (handle == INVALID_HANDLE_VALUE)
+		return;
+	file = handle;
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(handle, &fileSize))
+		return;
+	size = (size_t)fileSize.QuadPart;
+	opened = true;
+	if (size == 0)
+		return;
+	mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping != nullptr)
+		data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	opened = data != nullptr;
+#else
+	int descriptor = open(filepath.c_str(), O_RDONLY);
+	if (descriptor == -1)
+		return;
+	file = (void*)(intptr_t)(descriptor + 1);	//+1 so a descriptor of 0 is not mistaken for none
+	struct stat info;
+	if (fstat(descriptor, &info) != 0)
+		return;
+	size = (size_t)info.st_size;
+	opened = true;
+	if (size == 0)
+		return;
+	void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	if (mapped != MAP_FAILED) {
+		madvise(mapped, size, MADV_SEQUENTIAL);	//only a hint, most files are read front to back once
+		data = (const char*)mapped;
+	}
+	opened = data != nullptr;
+#endif
+}
+
+/**
+ * @brief Destroy the MappedFile::MappedFile object, unmapping and closing the file.
+ *
+ */
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+	if (data != nullptr)
+		UnmapViewOfFile(data);
+	if (mapping != nullptr)
+		CloseHandle((HANDLE)mapping);
+	if (file != nullptr)
+		CloseHandle((HANDLE)file);
+#else
+	if (data != nullptr)
+		munmap((void*)data, size);
+	if (file != nullptr)
+		close((int)(intptr_t)file - 1);
+#endif
+}
+
+/**
+ * @brief Returns when a file was last written to, without opening it.
+ *
+ * @param filepath 		- The file
+ * @return long long 	- Seconds since the epoch, -1 if the file does not exist
+ */
+long long MappedFile::modifiedTime(const std::string& filepath)
+{
+	struct stat info;
+	if (stat(filepath.c_str(), &info) != 0)
+		return -1;
+	return (long long)info.st_mtime;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file MappedFile.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the MappedFile class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * @class MappedFile
+ * @brief 	A read only view of a whole file, mapped into memory instead of read through a
+ * 			stream (mmap, or a file mapping on Windows). The pages are only read from disk
+ * 			when they are touched, and stay valid as long as the object.
+ */
+class MappedFile
+{
+public:
+	MappedFile(const std::string& filepath);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	static long long modifiedTime(const std::string& filepath);
+
+	inline const char* getData() const { return data; }	//nullptr for an empty file
+	inline size_t getSize()		 const { return size; }
+	inline bool isOpen()		 const { return opened; }
+
+private:
+	const char* data;
+	size_t size;
+	bool opened;
+	void* file;		//the file descriptor or handle
+	void* mapping;	//the mapping handle, only used on Windows
+};
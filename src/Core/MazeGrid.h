@@ -0,0 +1,48 @@
+/**
+ * @file MazeGrid.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief A view of the tiles of a level
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+//The largest width or height of a level, width * height stays below INT_MAX for the ints the tiles are indexed with
+const int MAX_LEVEL_SIDE = 32768;
+
+/**
+ * @class MazeGrid
+ * @brief 	The tiles of a level, one byte each row after row (see ScenarioLoader for their
+ * 			values), without owning them. It is only a pointer and the size, so it is passed
+ * 			by value; the ScenarioLoader owns the tiles of the game and has to outlive every
+ * 			MazeGrid of them.
+ */
+class MazeGrid
+{
+public:
+	MazeGrid()
+		: m_Tiles(nullptr), width(0), height(0) {}
+	MazeGrid(const uint8_t* tiles, int width, int height)
+		: m_Tiles(tiles), width(width), height(height) {}
+
+	inline int getWidth() const { return width; }
+	inline int getHeight() const { return height; }
+	inline size_t size() const { return (size_t)width * height; }
+	inline bool empty() const { return width == 0 || height == 0; }
+	inline const uint8_t* data() const { return m_Tiles; }
+
+	inline uint8_t operator()(int y, int x) const { return m_Tiles[(size_t)y * width + x]; }
+	inline uint8_t operator[](size_t i) const { return m_Tiles[i]; }
+	inline bool isWall(int y, int x) const { return (*this)(y, x) == 1; }
+	inline bool contains(int y, int x) const { return y >= 0 && y < height && x >= 0 && x < width; }
+
+private:
+	const uint8_t* m_Tiles;
+	int width,
+		height;
+};
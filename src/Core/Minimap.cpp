@@ -19,12 +19,12 @@
  * @param minimapShader - The minimap's shader
  * @param maze3D        - The 3d maze in which the game is being played
  * @param player        - The camera object controlled by the player
- * @param ghosts        - The ghosts in the 3d world. 
+ * @param sim           - The game simulation, the minimap only reads from it. 
  */
 Minimap::Minimap(ScenarioLoader* loadedLevel, Shader* maze2DShader, Renderer* renderer, 
-                 Shader* minimapShader, Maze3D* maze3D, Camera* player, std::vector<Ghost3D*> ghosts)
+                 Shader* minimapShader, Maze3D* maze3D, Camera* player, const GameSim* sim)
     :   m_Shader(minimapShader),
-        ghosts3D(ghosts)
+        m_Sim(sim)
 {
     this->maze3D = maze3D;
     generateQuad();
@@ -35,15 +35,16 @@ Minimap::Minimap(ScenarioLoader* loadedLevel, Shader* maze2DShader, Renderer* re
 
 
     
-    for (int i = 0; i < 3; i++)
+    const std::vector<SimGhost>& ghosts = m_Sim->getGhosts();
+    for (int i = 0; i < ghosts.size(); i++)
     {
         ghostShaders.push_back(new Shader("shaders/ghost2D.vs","shaders/ghost2D.fs"));
-        ghosts2D.push_back(new Ghost(maze3D, ghostShaders[i], renderer, 3 + i, "res/ghost/ghost",ghosts3D[i]));
+        ghosts2D.push_back(new Ghost(maze3D, ghostShaders[i], renderer, ghosts[i].id, "res/ghost/ghost",&ghosts[i]));
     }
 
 
     pacman2D = new Pacman(maze3D, pacman2DShader, renderer, 2, "res/pacman/pacman", ghosts2D, player );
-    pellets2D = new Pellets(maze3D, pellet2DShader, renderer);
+    pellets2D = new Pellets(m_Sim, pellet2DShader, renderer);
 }
 
 /**
@@ -63,14 +64,19 @@ void Minimap::Draw(Shader* shader, float dt)
 //==============================
 //The following will be rendered on the minimap:
 
-	maze2D->draw();
+    //Streamed levels only show the tiles around the player
+    const SimPlayer& player = m_Sim->getPlayer();
+    if (maze2D->follow(player.position.x, player.position.z))
+        pellets2D->setWindow(maze2D->getWindow());
+
+    maze2D->draw();
     pellets2D->draw();
     pacman2D->setPosition(dt);
-    pacman2D->draw();
+    pacman2D->draw(maze2D->getWindow());
 
-    for (int i = 0; i < 3; i++) {
+    for (int i = 0; i < ghosts2D.size(); i++) {
         ghosts2D[i]->setPosition(dt);
-        ghosts2D[i]->draw();
+        ghosts2D[i]->draw(maze2D->getWindow());
     }
     
 //=============================    
@@ -24,7 +24,7 @@ class Minimap
 {
 public:
 	Minimap(ScenarioLoader* loadedLevel, Shader* shader, Renderer* renderer, 
-			Shader* minimapShader, Maze3D* maze3D, Camera* player, std::vector<Ghost3D*> ghosts);
+			Shader* minimapShader, Maze3D* maze3D, Camera* player, const GameSim* sim);
 
 	void Draw(Shader* shader, float dt);
 private:
@@ -33,7 +33,7 @@ private:
 	Pellets* pellets2D;
 	MovableObject* pacman2D;
 	std::vector <MovableObject*> ghosts2D;
-	std::vector<Ghost3D*> ghosts3D;
+	const GameSim* m_Sim;
 
 	void generateQuad();
 
@@ -0,0 +1,433 @@
+/**
+ * @file NextHopTable.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class holding the first step of the shortest path between every pair of cells.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "NextHopTable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+namespace {
+	/**
+	 * @brief The header written in front of a saved table.
+	 */
+	struct TableHeader {
+		char				magic[4];	//"NHT1"
+		unsigned int		width,
+							height,
+							cellCount,
+							wrap;
+		unsigned long long	levelHash;
+	};
+}
+
+/**
+ * @brief Construct a new NextHopTable::NextHopTable object. Does not build the table.
+ *
+ * @param map 				- The 2d grid of the maze
+ * @param wrapHorizontal 	- Wheter or not walking off the left/right edge enters on the other side
+ * @param maxTableBytes 	- The largest table that is precomputed, larger levels compute rows on demand
+ * @param cacheRows 		- How many rows the LRU cache keeps when rows are computed on demand
+ */
+NextHopTable::NextHopTable(MazeGrid map, bool wrapHorizontal,
+						   size_t maxTableBytes, int cacheRows)
+	:	m_map(map),
+		height(map.getHeight()),
+		width(map.getWidth()),
+		wrap(wrapHorizontal),
+		precomputed(false),
+		maxBytes(maxTableBytes),
+		maxCachedRows(std::max(1, cacheRows)),
+		rows(nullptr),
+		field(nullptr)
+{
+	makeCells(map);
+	findComponents();
+	rowBytes = (cellCount + 3) / 4;
+}
+
+/**
+ * @brief Destroy the NextHopTable::NextHopTable object
+ *
+ */
+NextHopTable::~NextHopTable()
+{
+	delete field;
+}
+
+/**
+ * @brief 	Counts the walkable cells the table of a level would have, to decide whether to
+ * 			make one at all, without allocating anything per tile.
+ *
+ * @param map 	- The 2d grid of the maze
+ * @return int 	- The amount of tiles that are not walls
+ */
+int NextHopTable::countCells(MazeGrid map)
+{
+	return (int)std::count_if(map.data(), map.data() + map.size(), [](uint8_t tile) { return tile != 1; });
+}
+
+/**
+ * @brief 	Gives every walkable cell a compact id and stores its neighbours, so the
+ * 			searches never have to look at the walls again. Also hashes the level.
+ *
+ * @param map - The 2d grid of the maze
+ */
+void NextHopTable::makeCells(MazeGrid map)
+{
+	levelHash = 14695981039346656037ull; //FNV-1a
+	cellId.assign(height * width, -1);
+	cellTile.clear();
+	cellCount = 0;
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++) {
+			bool wall = map(y, x) == 1;
+			if (!wall) {
+				cellId[y * width + x] = cellCount++;
+				cellTile.push_back(y * width + x);
+			}
+			levelHash = (levelHash ^ (wall ? 1u : 0u)) * 1099511628211ull;
+		}
+	levelHash = (levelHash ^ (unsigned long long)wrap) * 1099511628211ull;
+
+	const int offsetY[4] = { -1, 1, 0, 0 }; //same order as FlowStep
+	const int offsetX[4] = { 0, 0, -1, 1 };
+
+	neighbours.assign(cellCount * 4, -1);
+	for (int y = 0; y < height; y++)
+		for (int x = 0; x < width; x++) {
+			int id = cellId[y * width + x];
+			if (id == -1)
+				continue;
+			for (int i = 0; i < 4; i++) {
+				int ny = y + offsetY[i];
+				int nx = x + offsetX[i];
+				if (wrap)	//the tunnel
+					nx = (nx + width) % width;
+				if (ny < 0 || ny >= height || nx < 0 || nx >= width)
+					continue;
+				neighbours[id * 4 + i] = cellId[ny * width + nx];
+			}
+		}
+}
+
+/**
+ * @brief 	Flood fills the walkable cells, a pair of cells only has a path if they
+ * 			are in the same component.
+ *
+ */
+void NextHopTable::findComponents()
+{
+	component.assign(cellCount, -1);
+	std::vector<int> stack;
+	int components = 0;
+	for (int start = 0; start < cellCount; start++) {
+		if (component[start] != -1)
+			continue;
+		component[start] = components;
+		stack.push_back(start);
+		while (!stack.empty()) {
+			int id = stack.back();
+			stack.pop_back();
+			for (int i = 0; i < 4; i++) {
+				int n = neighbours[id * 4 + i];
+				if (n != -1 && component[n] == -1) {
+					component[n] = components;
+					stack.push_back(n);
+				}
+			}
+		}
+		components++;
+	}
+}
+
+/**
+ * @brief 	Fills one row of the table with a breadth first search from the goal. Every
+ * 			cell that is reached stores the step back towards the cell it was reached from.
+ *
+ * @param goal 		- The walkable cell id of the goal
+ * @param row 		- rowBytes long buffer the packed row is written to
+ * @param queue 	- cellCount long scratch buffer
+ * @param visited 	- cellCount long scratch buffer
+ */
+void NextHopTable::buildRow(int goal, unsigned char* row, std::vector<int>& queue, std::vector<unsigned char>& visited) const
+{
+	const unsigned char backStep[4] = { StepDown, StepUp, StepRight, StepLeft };
+
+	std::fill(row, row + rowBytes, 0);
+	std::fill(visited.begin(), visited.end(), 0);
+
+	int head = 0, tail = 0;
+	visited[goal] = 1;
+	queue[tail++] = goal;
+	while (head < tail) {
+		int id = queue[head++];
+		for (int i = 0; i < 4; i++) {
+			int n = neighbours[id * 4 + i];
+			if (n == -1 || visited[n])
+				continue;
+			visited[n] = 1;
+			row[n >> 2] |= backStep[i] << ((n & 3) * 2);
+			queue[tail++] = n;
+		}
+	}
+}
+
+/**
+ * @brief 	Fills one row of the table from a flow field towards the goal, which floods the
+ * 			level with the bit-parallel search of its GridBitboard. Used for the rows computed
+ * 			on demand, one at a time.
+ *
+ * @param goal 		- The walkable cell id of the goal
+ * @param row 		- rowBytes long buffer the packed row is written to
+ */
+void NextHopTable::buildRowFromField(int goal, unsigned char* row)
+{
+	if (field == nullptr)
+		field = new FlowField(m_map, wrap);
+	field->build(cellTile[goal] / width, cellTile[goal] % width);
+
+	std::fill(row, row + rowBytes, 0);
+	for (int id = 0; id < cellCount; id++) {
+		FlowStep step = field->getStep(cellTile[id] / width, cellTile[id] % width);
+		if (step != StepNone)	//the goal and the cells of other components are never looked up
+			row[id >> 2] |= step << ((id & 3) * 2);
+	}
+}
+
+/**
+ * @brief 	Precomputes every row of the table, split over several threads. Does nothing
+ * 			if the table would be larger than the memory budget, rows are then computed
+ * 			on demand instead.
+ *
+ * @param threadCount - How many threads to use, 0 uses one per hardware thread
+ */
+void NextHopTable::build(unsigned int threadCount)
+{
+	if (!fitsInMemory() || cellCount == 0)
+		return;
+
+	if (threadCount == 0)
+		threadCount = std::max(1u, std::thread::hardware_concurrency());
+	threadCount = std::min(threadCount, (unsigned int)cellCount);
+
+	table.assign((size_t)cellCount * rowBytes, 0);
+
+	//Every thread builds every threadCount'th row, with its own scratch buffers
+	auto worker = [this, threadCount](unsigned int first) {
+		std::vector<int> queue(cellCount);
+		std::vector<unsigned char> visited(cellCount);
+		for (int goal = first; goal < cellCount; goal += threadCount)
+			buildRow(goal, &table[(size_t)goal * rowBytes], queue, visited);
+	};
+
+	std::vector<std::thread> threads;
+	for (unsigned int i = 1; i < threadCount; i++)
+		threads.emplace_back(worker, i);
+	worker(0);
+	for (auto& thread : threads)
+		thread.join();
+
+	precomputed = true;
+	rows = table.data();
+	lruOrder.clear();
+	cachedRows.clear();
+}
+
+/**
+ * @brief Saves a precomputed table to file, so it does not have to be built again.
+ *
+ * @param filepath 	- Where to save the table, usually next to the level file
+ * @return true 	- The table was saved
+ */
+bool NextHopTable::save(const std::string& filepath) const
+{
+	if (!precomputed)
+		return false;
+
+	std::ofstream file(filepath, std::ios::binary);
+	if (!file)
+		return false;
+
+	TableHeader header = { { 'N', 'H', 'T', '1' }, (unsigned int)width, (unsigned int)height,
+						   (unsigned int)cellCount, (unsigned int)wrap, levelHash };
+	file.write((const char*)&header, sizeof(header));
+	file.write((const char*)rows, (size_t)cellCount * rowBytes);
+	return (bool)file;
+}
+
+/**
+ * @brief Loads a table saved by save(), if it was made for this exact level.
+ *
+ * @param filepath 	- The file containing the table
+ * @return true 	- The table was loaded, and no rows have to be built
+ * @return false 	- There was no file, or it belongs to another level
+ */
+bool NextHopTable::load(const std::string& filepath)
+{
+	if (!fitsInMemory())
+		return false;
+
+	std::ifstream file(filepath, std::ios::binary);
+	if (!file)
+		return false;
+
+	TableHeader header;
+	if (!file.read((char*)&header, sizeof(header)) || !matches(&header))
+		return false;
+
+	std::vector<unsigned char> loaded((size_t)cellCount * rowBytes);
+	if (!file.read((char*)loaded.data(), loaded.size()))
+		return false;
+
+	table.swap(loaded);
+	precomputed = true;
+	rows = table.data();
+	return true;
+}
+
+/**
+ * @brief Writes the table the way save() does, into memory (for levelc).
+ *
+ * @param bytes - Set to the header followed by the table, empty if it is not precomputed
+ */
+void NextHopTable::serialize(std::vector<unsigned char>& bytes) const
+{
+	bytes.clear();
+	if (!precomputed)
+		return;
+
+	TableHeader header = { { 'N', 'H', 'T', '1' }, (unsigned int)width, (unsigned int)height,
+						   (unsigned int)cellCount, (unsigned int)wrap, levelHash };
+	bytes.resize(sizeof(header) + (size_t)cellCount * rowBytes);
+	std::memcpy(bytes.data(), &header, sizeof(header));
+	std::memcpy(bytes.data() + sizeof(header), rows, (size_t)cellCount * rowBytes);
+}
+
+/**
+ * @brief 	Uses a table written by serialize() in place, without copying it. The memory
+ * 			has to stay valid as long as this object (e.g. a memory mapped compiled level).
+ *
+ * @param data 		- The header followed by the table
+ * @param size 		- The size of data in bytes
+ * @return true 	- The table belongs to this level and is used from now on
+ */
+bool NextHopTable::borrow(const unsigned char* data, size_t size)
+{
+	TableHeader header;
+	if (data == nullptr || size < sizeof(header))
+		return false;
+	std::memcpy(&header, data, sizeof(header));
+	if (!matches(&header) || size - sizeof(header) < (size_t)cellCount * rowBytes)
+		return false;
+
+	table.clear();
+	precomputed = true;
+	rows = data + sizeof(header);
+	lruOrder.clear();
+	cachedRows.clear();
+	return true;
+}
+
+/**
+ * @brief Checks wheter a saved table was made for this exact level.
+ *
+ * @param header 	- The TableHeader in front of the saved table
+ * @return true 	- Same size, walls and tunnel as this level
+ */
+bool NextHopTable::matches(const void* header) const
+{
+	const TableHeader* saved = (const TableHeader*)header;
+	return std::string(saved->magic, 4) == "NHT1" && saved->width == (unsigned int)width && saved->height == (unsigned int)height &&
+		   saved->cellCount == (unsigned int)cellCount && saved->wrap == (unsigned int)wrap && saved->levelHash == levelHash;
+}
+
+/**
+ * @brief 	Returns the row for a goal. Precomputed tables return it directly, otherwise
+ * 			it is taken from (or built into) the LRU cache.
+ *
+ * @param goal 	- The walkable cell id of the goal
+ * @return const unsigned char* - The packed row
+ */
+const unsigned char* NextHopTable::getRow(int goal)
+{
+	if (precomputed)
+		return rows + (size_t)goal * rowBytes;
+
+	auto cached = cachedRows.find(goal);
+	if (cached != cachedRows.end()) {
+		lruOrder.splice(lruOrder.begin(), lruOrder, cached->second.first); //mark as most recently used
+		return cached->second.second.data();
+	}
+
+	std::vector<unsigned char> row;
+	if ((int)cachedRows.size() >= maxCachedRows) { //evict the least recently used row, reusing its memory
+		auto oldest = cachedRows.find(lruOrder.back());
+		row.swap(oldest->second.second);
+		cachedRows.erase(oldest);
+		lruOrder.pop_back();
+	}
+	row.resize(rowBytes);
+	buildRowFromField(goal, row.data());
+
+	lruOrder.push_front(goal);
+	auto& entry = cachedRows[goal];
+	entry.first = lruOrder.begin();
+	entry.second.swap(row);
+	return entry.second.data();
+}
+
+/**
+ * @brief Looks up the first step of the shortest path from a cell to a goal.
+ *
+ * @param y 		- The y coordinate of the cell
+ * @param x 		- The x coordinate of the cell
+ * @param goalY 	- The y coordinate of the goal
+ * @param goalX 	- The x coordinate of the goal
+ * @param step 		- Is set to the step towards the goal
+ * @return true 	- There is a next step
+ * @return false 	- The cell is the goal, one of them is a wall, or there is no path
+ */
+bool NextHopTable::NextStep(int y, int x, int goalY, int goalX, FlowStep& step)
+{
+	if (y < 0 || y >= height || x < 0 || x >= width ||
+		goalY < 0 || goalY >= height || goalX < 0 || goalX >= width)
+		return false;
+
+	int from = cellId[y * width + x];
+	int goal = cellId[goalY * width + goalX];
+	if (from == -1 || goal == -1 || from == goal || component[from] != component[goal])
+		return false;
+
+	const unsigned char* row = getRow(goal);
+	step = (FlowStep)((row[from >> 2] >> ((from & 3) * 2)) & 3);
+	return true;
+}
+
+/**
+ * @brief 	Makes sure the row towards a goal is there, computing it if it is not in the
+ * 			cache, so NextStep() towards the goal is a lookup until the row is evicted.
+ * 			The row loaded last is the most recently used, it stays until another is loaded.
+ *
+ * @param goalY 	- The y coordinate of the goal
+ * @param goalX 	- The x coordinate of the goal
+ * @return true 	- The goal can be walked on and its row is there
+ */
+bool NextHopTable::loadRow(int goalY, int goalX)
+{
+	if (goalY < 0 || goalY >= height || goalX < 0 || goalX >= width)
+		return false;
+	int goal = cellId[goalY * width + goalX];
+	if (goal == -1)
+		return false;
+	getRow(goal);
+	return true;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file NextHopTable.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the NextHopTable class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "FlowField.h"
+
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <string>
+
+/**
+ * @class NextHopTable
+ * @brief 	All pairs table holding the first step of the shortest path between every pair
+ * 			of walkable cells, packed at 2 bits per entry. A path query is a single lookup.
+ * 			Row g holds the step every cell takes towards goal g, and is one breadth first
+ * 			search from g. Small levels precompute every row (multithreaded) and can be saved
+ * 			next to the level file, levels whose table would not fit in the memory budget
+ * 			compute rows on demand with a FlowField and keep the most recently used ones in
+ * 			an LRU cache.
+ */
+class NextHopTable
+{
+public:
+	static const size_t DEFAULT_MAX_BYTES = 16 * 1024 * 1024;	//the largest table the game precomputes
+
+	NextHopTable(MazeGrid map, bool wrapHorizontal = true,
+				 size_t maxTableBytes = DEFAULT_MAX_BYTES, int cacheRows = 64);
+	~NextHopTable();
+
+	NextHopTable(const NextHopTable&) = delete;
+	NextHopTable& operator=(const NextHopTable&) = delete;
+
+	void build(unsigned int threadCount = 0);
+	bool save(const std::string& filepath) const;
+	bool load(const std::string& filepath);
+	void serialize(std::vector<unsigned char>& bytes) const;
+	bool borrow(const unsigned char* data, size_t size);
+
+	bool NextStep(int y, int x, int goalY, int goalX, FlowStep& step);
+	bool loadRow(int goalY, int goalX);
+
+	inline bool   isPrecomputed() const { return precomputed; }
+	inline bool   fitsInMemory()  const { return fitsInMemory(cellCount, maxBytes); }
+	inline int    getCellCount()  const { return cellCount; }
+	inline size_t getTableBytes() const { return precomputed ? (size_t)cellCount * rowBytes : 0; }
+
+	//Whether the table of a level with cellCount walkable cells would be precomputed, without making one
+	static inline bool fitsInMemory(int cellCount, size_t maxTableBytes) { return (size_t)cellCount * ((cellCount + 3) / 4) <= maxTableBytes; }
+	static int countCells(MazeGrid map);
+
+private:
+	MazeGrid m_map;
+	int height, width;
+	int cellCount;		//amount of walkable cells, the table is cellCount x cellCount
+	int rowBytes;		//one row packs cellCount entries of 2 bits
+	bool wrap;
+	bool precomputed;
+	size_t maxBytes;
+	int maxCachedRows;
+	unsigned long long levelHash;	//used to make sure a saved table belongs to this level
+
+	std::vector<int>			cellId;		//y * width + x -> walkable cell id, -1 for walls
+	std::vector<int>			cellTile;	//walkable cell id -> y * width + x
+	std::vector<int>			neighbours;	//4 per walkable cell (up, down, left, right), -1 for none
+	std::vector<int>			component;	//connected component of every walkable cell
+	std::vector<unsigned char>	table;		//every row, only used when precomputed
+	const unsigned char*		rows;		//the table, or the one borrowed from a compiled level
+
+	//LRU cache of rows, used when the whole table would not fit
+	std::list<int> lruOrder;
+	std::unordered_map<int, std::pair<std::list<int>::iterator, std::vector<unsigned char>>> cachedRows;
+	FlowField* field;	//builds the rows of the cache, nullptr until the first
+
+	bool matches(const void* header) const;
+	void makeCells(MazeGrid map);
+	void findComponents();
+	void buildRow(int goal, unsigned char* row, std::vector<int>& queue, std::vector<unsigned char>& visited) const;
+	void buildRowFromField(int goal, unsigned char* row);
+	const unsigned char* getRow(int goal);
+};
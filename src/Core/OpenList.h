@@ -0,0 +1,121 @@
+/**
+ * @file OpenList.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief The open list policies the AStar class can be compiled with.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief 	An entry in the open list. Only the combined cost and the flat index of the
+ * 			cell is stored, the rest of the data lives in the scratch buffer.
+ */
+struct OpenNode {
+	float			fCost;
+	unsigned int	index;	//y * width + x
+};
+
+/**
+ * @brief A struct containing the function for comparing two nodes, used in combination
+ * 		  with the heap we are using for keeping track of nodes.
+ *
+ */
+struct CompareFCost {
+	bool operator()(OpenNode const& n1, OpenNode const& n2) {
+		return n1.fCost > n2.fCost; //compares the combined value of travelled distance and heuristics in any given node
+	}
+};
+
+/**
+ * @class BinaryHeap
+ * @brief 	Open list keyed on a float cost. Works for any non negative edge weights,
+ * 			so it is the one to use for weighted graphs. Push and pop are O(log n).
+ */
+class BinaryHeap
+{
+public:
+	typedef float Key;
+
+	inline void reserve(size_t size) { heap.reserve(size); }
+	inline void clear() { heap.clear(); }
+	inline bool empty() const { return heap.empty(); }
+
+	inline void push(Key fCost, unsigned int index)
+	{
+		heap.push_back({ fCost, index });
+		std::push_heap(heap.begin(), heap.end(), CompareFCost());
+	}
+
+	inline unsigned int pop()
+	{
+		std::pop_heap(heap.begin(), heap.end(), CompareFCost()); //Picks the lowest fCost element
+		unsigned int index = heap.back().index;
+		heap.pop_back();
+		return index;
+	}
+
+private:
+	std::vector<OpenNode> heap;
+};
+
+/**
+ * @class BucketQueue
+ * @brief 	Open list keyed on an integer cost, with one bucket of cell indices per cost.
+ * 			On a grid where every step costs 1 (and the heuristic is consistent) the smallest
+ * 			cost in the list never decreases, so pop only has to move a cursor forward and
+ * 			push and pop are O(1). Entries with equal cost are popped newest first, which
+ * 			follows one path towards the goal instead of fanning out. The buckets keep
+ * 			their memory between queries.
+ */
+class BucketQueue
+{
+public:
+	typedef unsigned int Key;
+
+	BucketQueue() : cursor(0), highest(0), count(0) {}
+
+	inline void reserve(size_t size) { buckets.reserve(size); }
+
+	inline void clear()
+	{
+		for (unsigned int f = cursor; f <= highest && f < buckets.size(); f++)
+			buckets[f].clear();
+		cursor = highest = 0;
+		count = 0;
+	}
+
+	inline bool empty() const { return count == 0; }
+
+	inline void push(Key fCost, unsigned int index)
+	{
+		if (fCost >= buckets.size())
+			buckets.resize(fCost + 1);
+		buckets[fCost].push_back(index);
+		if (count == 0 || fCost < cursor)	//only happens with an inconsistent heuristic
+			cursor = fCost;
+		highest = std::max(highest, fCost);
+		count++;
+	}
+
+	inline unsigned int pop()
+	{
+		while (buckets[cursor].empty())
+			cursor++;
+		unsigned int index = buckets[cursor].back();
+		buckets[cursor].pop_back();
+		count--;
+		return index;
+	}
+
+private:
+	std::vector<std::vector<unsigned int>> buckets;	//fCost -> cell indices
+	unsigned int cursor;	//no bucket below this holds anything
+	unsigned int highest;	//no bucket above this holds anything
+	size_t count;
+};
@@ -23,10 +23,30 @@ void Renderer::Draw(VertexArray* va, IndexBuffer* ib, Shader* shader) const
 	shader->use();
 	va->Bind();
 	ib->Bind();
-	glDrawElements(GL_TRIANGLES, ib->getCount(), GL_UNSIGNED_INT, nullptr);
+	glDrawElements(GL_TRIANGLES, ib->getCount(), ib->getType(), nullptr);
 
 }
 
+/**
+ * @brief Draws some ranges of an object's indices with a single call.
+ *
+ * @param va 		- The object to be drawn's VertexArray.
+ * @param ib 		- The object to be drawn's IndexBuffer.
+ * @param shader 	- The object to be drawn's Shader.
+ * @param counts 	- How many indices each range has.
+ * @param offsets 	- Where in the IndexBuffer each range starts, in bytes (see IndexBuffer::getIndexSize()).
+ */
+void Renderer::MultiDraw(VertexArray* va, IndexBuffer* ib, Shader* shader,
+						 const std::vector<GLsizei>& counts, const std::vector<const void*>& offsets) const
+{
+	if (counts.empty())
+		return;
+	shader->use();
+	va->Bind();
+	ib->Bind();
+	glMultiDrawElements(GL_TRIANGLES, counts.data(), ib->getType(), offsets.data(), (GLsizei)counts.size());
+}
+
 /**
  * @brief Clears the screen in RGB colors.
  * 
@@ -14,6 +14,8 @@
 #include "IndexBuffer.h"
 #include "Shader.h"
 
+#include <vector>
+
 /**
  * @class Renderer
  * @brief Handles everything related to rendering objects. 
@@ -22,5 +24,7 @@ class Renderer
 {
 public:
 	void Draw(VertexArray* va, IndexBuffer* ib, Shader* shader) const;
+	void MultiDraw(VertexArray* va, IndexBuffer* ib, Shader* shader,
+				   const std::vector<GLsizei>& counts, const std::vector<const void*>& offsets) const;
 	void Clear(float f0, float f1, float f2, float f3) const;
 };
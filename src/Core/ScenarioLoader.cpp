@@ -4,50 +4,285 @@
  * @brief The source file for the ScenarioLoader class
  * @version 0.1
  * @date 2020-10-12
- * 
+ *
  * @copyright Copyright (c) 2020
- * 
+ *
  */
 #include "ScenarioLoader.h"
+#include "CompiledLevel.h"
+#include "EmbeddedAssets.h"
+#include "MappedFile.h"
 
-#include <fstream>
+#include <cstring>
 #include <string>
 #include <iostream>
 #include <vector>
 
-#include <glm/glm.hpp>
+namespace {
+	const int MAX_SIDE = MAX_LEVEL_SIDE;	//largest width or height accepted
+
+	inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+	inline bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+	inline const char* skipBlanks(const char* p, const char* end)
+	{
+		while (p != end && isBlank(*p))
+			p++;
+		return p;
+	}
+
+	/**
+	 * @brief 	Reads a whole number, p is left after its last digit.
+	 *
+	 * @param p 	- The first digit
+	 * @param end 	- The end of the file
+	 * @param limit - The largest value accepted
+	 * @return int 	- The number, -1 if it is larger than the limit
+	 */
+	int readNumber(const char*& p, const char* end, int limit)
+	{
+		int value = 0;
+		while (p != end && isDigit(*p)) {
+			value = value * 10 + (*p++ - '0');
+			if (value > limit) {
+				while (p != end && isDigit(*p))
+					p++;
+				return -1;
+			}
+		}
+		return value;
+	}
+
+	std::string describe(const char* p, const char* end)
+	{
+		if (p == end)
+			return "end of file";
+		if (*p == '\n')
+			return "end of line";
+		if (*p < ' ' || *p > '~')
+			return "byte " + std::to_string((unsigned char)*p);
+		return std::string("'") + *p + "'";
+	}
+}
 
 /**
  * @brief Construct a new Scenario Loader:: Scenario Loader object
  * 
- * @param filepath - The path to the file containing the level (maze).
+ * @param filepath 		- The path to the file containing the level (maze).
+ * @param useCompiled 	- Wheter or not to use the level embedded into the executable or compiled
+ * 						  by levelc, if there is one
  */
-ScenarioLoader::ScenarioLoader(const std::string& filepath)
+ScenarioLoader::ScenarioLoader(const std::string& filepath, bool useCompiled)
+	: horizontalSize(0),
+	  verticalSize(0),
+	  m_FilePath(filepath),
+	  m_Compiled(nullptr),
+	  m_Tiles(nullptr),
+	  m_Embedded(false)
 {
-	std::ifstream levelFile(filepath);
-	levelFile >> horizontalSize; levelFile.ignore(); levelFile >> verticalSize;
+	const EmbeddedLevel* embedded = useCompiled ? findEmbeddedLevel(filepath.c_str()) : nullptr;
+	if (embedded != nullptr) {
+		//Already parsed and checked when the executable was built
+		horizontalSize = embedded->width;
+		verticalSize = embedded->height;
+		m_Tiles = embedded->tiles;
+		m_Embedded = true;
+		return;
+	}
+	if (useCompiled && loadCompiled())
+		return;
 
-	int temp = 0;
-	for (int i = 0; i < verticalSize; i++)
-	{
-		for (int j = 0; j < horizontalSize; j++)
-		{
-			levelFile >> temp;			//reading a new value
-			mazeMap.push_back(temp);	//storing it in the mazeMap vector
+	MappedFile file(filepath);
+	bool loaded = file.isOpen() ? parse(file.getData(), file.getData() + file.getSize())
+								: fail(0, 0, "could not open the file");
+	if (!loaded) {
+		horizontalSize = verticalSize = 0;
+		grid.clear();
+		std::cout << "ERROR::LEVEL:: " << m_Error << std::endl;
+	}
+	m_Tiles = grid.data();
+}
+
+/**
+ * @brief Destroy the Scenario Loader:: Scenario Loader object
+ * 
+ */
+ScenarioLoader::~ScenarioLoader()
+{
+	delete m_Compiled;
+}
+
+/**
+ * @brief 	Uses the level compiled by levelc, if it exists, is not older than the level
+ * 			file and has the tiles.
+ *
+ * @return true - The tiles are read from the compiled level
+ */
+bool ScenarioLoader::loadCompiled()
+{
+	std::string compiledPath = CompiledLevel::pathFor(m_FilePath);
+	long long compiledTime = MappedFile::modifiedTime(compiledPath);
+	if (compiledTime == -1 || compiledTime < MappedFile::modifiedTime(m_FilePath))
+		return false;
+
+	CompiledLevel* compiled = new CompiledLevel(compiledPath);
+	size_t count = 0;
+	const uint8_t* tiles = compiled->isLoaded() ? compiled->getSection<uint8_t>(LevelSection::Tiles, count) : nullptr;
+	if (tiles == nullptr || count == 0 || count != (size_t)compiled->getWidth() * compiled->getHeight() ||
+		compiled->getWidth() > MAX_SIDE || compiled->getHeight() > MAX_SIDE) {
+		delete compiled;
+		return false;
+	}
+
+	m_Compiled = compiled;
+	m_Tiles = tiles;
+	horizontalSize = compiled->getWidth();
+	verticalSize = compiled->getHeight();
+	return true;
+}
+
+/**
+ * @brief 	Parses the level file: the size as "<width>x<height>" on the first line, then
+ * 			one line per row of the maze with width values separated by spaces. Tiles are
+ * 			one digit in every level we have, so the scanner reads four of them at a time
+ * 			("d d d d " is eight bytes, checked and split in a single 64 bit word), and
+ * 			only falls back to reading byte by byte at the end of a row, for values with
+ * 			more digits or for anything that is not laid out like that.
+ *
+ * @param begin - The first byte of the file
+ * @param end 	- One past the last byte of the file
+ * @return true - The file was a valid level, the grid holds it
+ */
+bool ScenarioLoader::parse(const char* begin, const char* end)
+{
+	const char* p = begin;
+	const char* lineStart = begin;
+	int line = 1;
+
+	p = skipBlanks(p, end);
+	if (p == end || !isDigit(*p))
+		return fail(line, p - lineStart + 1, "expected the width, found " + describe(p, end));
+	horizontalSize = readNumber(p, end, MAX_SIDE);
+	if (p == end || (*p != 'x' && *p != 'X'))
+		return fail(line, p - lineStart + 1, "expected 'x' between the width and height, found " + describe(p, end));
+	p++;
+	if (p == end || !isDigit(*p))
+		return fail(line, p - lineStart + 1, "expected the height, found " + describe(p, end));
+	verticalSize = readNumber(p, end, MAX_SIDE);
+	if (horizontalSize <= 0 || verticalSize <= 0)
+		return fail(line, 1, "the width and height must be between 1 and " + std::to_string(MAX_SIDE));
+	p = skipBlanks(p, end);
+	if (p != end && *p != '\n')
+		return fail(line, p - lineStart + 1, "expected the end of the line, found " + describe(p, end));
+
+	//Every tile takes at least two bytes, a digit and a space or newline
+	size_t tiles = (size_t)horizontalSize * verticalSize;
+	if ((size_t)(end - p) < tiles * 2 - 1)
+		return fail(line, 1, "the file is too short for a " + std::to_string(horizontalSize) + "x" +
+						  std::to_string(verticalSize) + " level");
+	grid.resize(tiles);
+
+	for (int y = 0; y < verticalSize; y++) {
+		if (p == end)
+			return fail(line, p - lineStart + 1, "expected " + std::to_string(verticalSize) + " rows, found " + std::to_string(y));
+		p++;	//the newline ending the previous line
+		line++;
+		lineStart = p;
+
+		uint8_t* row = &grid[(size_t)y * horizontalSize];
+		int x = 0;
+		while (x < horizontalSize) {
+			p = skipBlanks(p, end);
+
+			//Four tiles at a time, as long as one more follows on the row (the fourth space would be the newline otherwise).
+			//XOR with "0 0 0 0 " turns the digits into their values and the spaces into 0, anything else sets
+			//a bit in the high nibble or in an odd byte, or goes above 9.
+			while (horizontalSize - x > 4 && end - p >= 8) {
+				uint64_t word;
+				std::memcpy(&word, p, 8);	//little endian, the first byte is the lowest
+				uint64_t cells = word ^ 0x2030203020302030ull;
+				if ((cells & 0xFFF0FFF0FFF0FFF0ull) | ((cells + 0x0006000600060006ull) & 0x00F000F000F000F0ull))
+					break;
+				row[x]	   = (uint8_t)cells;
+				row[x + 1] = (uint8_t)(cells >> 16);
+				row[x + 2] = (uint8_t)(cells >> 32);
+				row[x + 3] = (uint8_t)(cells >> 48);
+				x += 4;
+				p += 8;
+			}
+
+			p = skipBlanks(p, end);
+			if (p == end || *p == '\n')
+				return fail(line, p - lineStart + 1, "expected " + std::to_string(horizontalSize) + " values, found " + std::to_string(x));
+			if (!isDigit(*p))
+				return fail(line, p - lineStart + 1, "expected a value, found " + describe(p, end));
+			const char* number = p;
+			int value = readNumber(p, end, 255);
+			if (value < 0)
+				return fail(line, number - lineStart + 1, "the value is larger than 255");
+			if (p != end && *p != '\n' && !isBlank(*p))
+				return fail(line, p - lineStart + 1, "expected a space, found " + describe(p, end));
+			row[x++] = (uint8_t)value;
+		}
+
+		p = skipBlanks(p, end);
+		if (p != end && *p != '\n')
+			return fail(line, p - lineStart + 1, "expected " + std::to_string(horizontalSize) + " values, found more");
+	}
+
+	//Only empty lines may follow the last row
+	while (p != end) {
+		if (*p == '\n') {
+			line++;
+			lineStart = p + 1;
 		}
+		else if (!isBlank(*p))
+			return fail(line, p - lineStart + 1, "expected " + std::to_string(verticalSize) + " rows, found more");
+		p++;
 	}
+	return true;
+}
+
+/**
+ * @brief Stores an error message pointing at the broken part of the file.
+ *
+ * @param line 		- The line of the problem, counting from 1 (0 if it is not in the file)
+ * @param column 	- The column of the problem, counting from 1
+ * @param message 	- What is wrong
+ * @return false 	- Always, so a failing parse can return it
+ */
+bool ScenarioLoader::fail(int line, int column, const std::string& message)
+{
+	m_Error = m_FilePath;
+	if (line > 0)
+		m_Error += ":" + std::to_string(line) + ":" + std::to_string(column);
+	m_Error += ": " + message;
+	return false;
+}
 
+/**
+ * @brief How many ghosts the level has, every ID from 3 up to the highest one in the level gets one.
+ *
+ * @return int - 0 if the level has no ghost IDs
+ */
+int ScenarioLoader::countGhosts() const
+{
+	int highestId = 2;
+	for (size_t i = 0; i < (size_t)horizontalSize * verticalSize; i++)
+		if (m_Tiles[i] != EMPTY_TILE && m_Tiles[i] > highestId)
+			highestId = m_Tiles[i];
+	return highestId - 2;
 }
 
 /**
- * @brief Prints the currently stored "map", used for debugging only. 
- * 
+ * @brief Prints the currently stored "map", used for debugging only.
+ *
  */
 void ScenarioLoader::printMazeMap()
 {
 	for (int i = 0; i < (horizontalSize * verticalSize); i++)
 	{
 		if (i % horizontalSize == 0) std::cout << std::endl;
-		std::cout << mazeMap[i] << ' ';
+		std::cout << (int)m_Tiles[i] << ' ';
 	}
-}
\ No newline at end of file
+}
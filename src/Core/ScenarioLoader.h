@@ -9,27 +9,59 @@
  * 
  */
 #pragma once
+#include "MazeGrid.h"
+
+#include <cstdint>
 #include <string>
 #include <vector>
 
-#include <GL/glew.h>
-#include <glm/glm.hpp>
+class CompiledLevel;
+
+//The values of the tiles: 0 is floor with a pellet, 1 a wall, 2 the player's spawn and from 3 the
+//ghosts (ghost i uses 3 + i). The highest value is floor without a pellet.
+const uint8_t EMPTY_TILE = 255;
 
 /**
  * @class ScenarioLoader
- * @brief  Handles the loading and saving of the content in the level files. 
+ * @brief  	Handles the loading and saving of the content in the level files. A level
+ * 			embedded into the executable (EMBED_ASSETS) is used as it is, without touching
+ * 			the disk. If levelc has compiled the level (<level>.lvlc, at least as new as the
+ * 			level file) the tiles are used straight from it. Otherwise the file is memory mapped and parsed into
+ * 			one byte per tile, row by row. If the file is broken the sizes are 0, the grid
+ * 			is empty and getError() tells the line and column of the problem.
  */
 class ScenarioLoader
 {
 private:
 	int horizontalSize, verticalSize;
+	std::string m_FilePath;
+	std::string m_Error;
+	std::vector <uint8_t> grid;	//will hold data regarding the map of the maze, row after row
+	CompiledLevel* m_Compiled;	//nullptr if the level was parsed
+	const uint8_t* m_Tiles;		//the grid, or the tiles of the embedded or compiled level
+	bool m_Embedded;
+
+	bool loadCompiled();
+	bool parse(const char* begin, const char* end);
+	bool fail(int line, int column, const std::string& message);
 public:
-	std::vector <int> mazeMap;	//will hold data regarding the map of the maze
-	ScenarioLoader(const std::string& filepath);
+	ScenarioLoader(const std::string& filepath, bool useCompiled = true);
+	~ScenarioLoader();
+	ScenarioLoader(const ScenarioLoader&) = delete;
+	ScenarioLoader& operator=(const ScenarioLoader&) = delete;
+
 	void printMazeMap();
 	int getHorizontalSize() { return horizontalSize; }
 	int getVerticalSize() { return verticalSize; }
+	const std::string& getFilePath() const { return m_FilePath; }
+	const std::string& getError() const { return m_Error; }
+	bool isLoaded() const { return m_Error.empty(); }
+	const CompiledLevel* getCompiledLevel() const { return m_Compiled; }
+	bool isEmbedded() const { return m_Embedded; }
 
-	int getValue(const int i) { return mazeMap[i]; }
-	int getVecSize() { return mazeMap.size(); }
-};
\ No newline at end of file
+	MazeGrid getGrid() const { return MazeGrid(m_Tiles, horizontalSize, verticalSize); }	//stays valid as long as the loader
+	int getTile(const int y, const int x) const { return m_Tiles[y * horizontalSize + x]; }
+	int getValue(const int i) { return m_Tiles[i]; }
+	int getVecSize() { return horizontalSize * verticalSize; }
+	int countGhosts() const;
+};
@@ -12,8 +12,10 @@
 #include "stb_image.h"
 
 #include "Texture.h"
+#include "Vfs.h"
 #include "GL/glew.h"
 #include <iostream>
+#include <vector>
 
 /**
  * @brief Construct a new Texture:: Texture object
@@ -32,7 +34,9 @@ Texture::Texture(const std::string& filepath)
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	stbi_set_flip_vertically_on_load(1);
-	m_LocalBuffer = stbi_load(filepath.c_str(), &m_Width, &m_Height, &m_BPP, 4);
+	std::vector<unsigned char> file;
+	if (Vfs::read(filepath, file))
+		m_LocalBuffer = stbi_load_from_memory(file.data(), (int)file.size(), &m_Width, &m_Height, &m_BPP, 4);
 	
 	glGenTextures(1, &m_RendererID);
 
@@ -88,6 +92,18 @@ void Texture::Bind(unsigned int slot) const
 	glBindTexture(GL_TEXTURE_2D, m_RendererID);
 }
 
+/**
+ * @brief Makes the texture repeat outside of 0 to 1, for texture coordinates running along merged faces.
+ *
+ */
+void Texture::setRepeating() const
+{
+	Bind(0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	Unbind();
+}
+
 /**
  * @brief Unbinds the texture. 
  * 
@@ -29,6 +29,7 @@ public:
 
 	void Bind(unsigned int slot = 0) const;
 	void Unbind() const;
+	void setRepeating() const;
 
 	int getWidth() const { return m_Width; }
 	int getHeight() const { return m_Height; }
@@ -45,8 +45,11 @@ void VertexArray::AddBuffer(const VertexBuffer& vb, const VertexBufferLayout& la
 	{
 		const auto& element = elements[i];
 		glEnableVertexAttribArray(i);
-		glVertexAttribPointer(i, element.count, element.type, element.normalized,
-			layout.getStride(), (const void*)offset);
+		if (element.integer)
+			glVertexAttribIPointer(i, element.count, element.type, layout.getStride(), (const void*)offset);
+		else
+			glVertexAttribPointer(i, element.count, element.type, element.normalized,
+				layout.getStride(), (const void*)offset);
 		offset += element.count * VertexBufferElement::getSizeOfType(element.type);
 	}
 }
@@ -22,6 +22,7 @@ struct VertexBufferElement
 	unsigned int type;
 	unsigned int count;
 	unsigned char normalized;
+	bool integer;	//read as integers by the shader, with glVertexAttribIPointer
 
 	static unsigned int getSizeOfType(unsigned int type)
 	{
@@ -29,6 +30,8 @@ struct VertexBufferElement
 		{
 			case GL_FLOAT:				return 4;
 			case GL_UNSIGNED_INT:		return 4;
+			case GL_SHORT:				return 2;
+			case GL_UNSIGNED_SHORT:		return 2;
 			case GL_UNSIGNED_BYTE: 	    return 1;
 		}
 		return 0;
@@ -57,24 +60,47 @@ public:
 	template<>
 	void Push<float>(unsigned int count)
 	{
-		m_Elements.push_back({ GL_FLOAT,count,GL_FALSE });
+		m_Elements.push_back({ GL_FLOAT,count,GL_FALSE,false });
 		m_Stride += count * VertexBufferElement::getSizeOfType(GL_FLOAT);
 	}
 
 	template<>
 	void Push<unsigned int>(unsigned int count)
 	{
-		m_Elements.push_back({ GL_UNSIGNED_INT,count,GL_FALSE });
+		m_Elements.push_back({ GL_UNSIGNED_INT,count,GL_FALSE,false });
 		m_Stride += count * VertexBufferElement::getSizeOfType(GL_UNSIGNED_INT);
 	}
 
 	template<>
 	void Push<unsigned char>(unsigned int count)
 	{
-		m_Elements.push_back({ GL_UNSIGNED_BYTE,count,GL_TRUE });
+		m_Elements.push_back({ GL_UNSIGNED_BYTE,count,GL_TRUE,false });
 		m_Stride += count * VertexBufferElement::getSizeOfType(GL_UNSIGNED_BYTE);
 	}
 
+	/**
+	 * @brief Adds an attribute the shader reads as integers (ivec/uvec), not converted to floats.
+	 */
+	template<typename T>
+	void PushInteger(unsigned int count)
+	{
+		static_assert(false);
+	}
+
+	template<>
+	void PushInteger<short>(unsigned int count)
+	{
+		m_Elements.push_back({ GL_SHORT,count,GL_FALSE,true });
+		m_Stride += count * VertexBufferElement::getSizeOfType(GL_SHORT);
+	}
+
+	template<>
+	void PushInteger<unsigned short>(unsigned int count)
+	{
+		m_Elements.push_back({ GL_UNSIGNED_SHORT,count,GL_FALSE,true });
+		m_Stride += count * VertexBufferElement::getSizeOfType(GL_UNSIGNED_SHORT);
+	}
+
 	inline const std::vector<VertexBufferElement> getElements() const { return m_Elements; }
 	inline unsigned int getStride() const { return m_Stride; }
 };
@@ -0,0 +1,121 @@
+/**
+ * @file Vfs.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Functions reading the asset files, from the executable, an asset pack or the disk.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "Vfs.h"
+#include "AssetPack.h"
+#include "EmbeddedAssets.h"
+
+#include <fstream>
+#include <iterator>
+
+namespace {
+	std::vector<AssetPack*> packs;
+
+	/**
+	 * @brief The path as it is stored in a pack, '/' between the folders and without a leading "./".
+	 */
+	std::string normalize(const std::string& path)
+	{
+		std::string normalized = path;
+		for (auto& c : normalized)
+			if (c == '\\')
+				c = '/';
+		while (normalized.compare(0, 2, "./") == 0)
+			normalized.erase(0, 2);
+		return normalized;
+	}
+}
+
+/**
+ * @brief Mounts an asset pack, its files are used instead of the ones on the disk.
+ *
+ * @param packPath 	- The pack written by assetpack
+ * @return true 	- The pack was mounted, false if it is missing or broken
+ */
+bool Vfs::mount(const std::string& packPath)
+{
+	AssetPack* pack = new AssetPack(packPath);
+	if (!pack->isLoaded()) {
+		delete pack;
+		return false;
+	}
+	packs.push_back(pack);
+	return true;
+}
+
+/**
+ * @brief Unmounts every asset pack.
+ *
+ */
+void Vfs::unmountAll()
+{
+	for (auto pack : packs)
+		delete pack;
+	packs.clear();
+}
+
+/**
+ * @brief Checks wheter a file can be read.
+ *
+ * @param path 	- The path of the file
+ * @return true - It is embedded, in a pack or on the disk
+ */
+bool Vfs::exists(const std::string& path)
+{
+	std::string normalized = normalize(path);
+	if (findEmbeddedFile(normalized.c_str()) != nullptr)
+		return true;
+	for (auto pack = packs.rbegin(); pack != packs.rend(); pack++)
+		if ((*pack)->contains(normalized))
+			return true;
+	return std::ifstream(path).good();
+}
+
+/**
+ * @brief Reads a whole file.
+ *
+ * @param path 	- The path of the file
+ * @param data 	- Set to the content of the file
+ * @return true - The file was read
+ */
+bool Vfs::read(const std::string& path, std::vector<unsigned char>& data)
+{
+	std::string normalized = normalize(path);
+	const EmbeddedFile* embedded = findEmbeddedFile(normalized.c_str());
+	if (embedded != nullptr) {
+		data.assign(embedded->data, embedded->data + embedded->size);
+		return true;
+	}
+	for (auto pack = packs.rbegin(); pack != packs.rend(); pack++)
+		if ((*pack)->read(normalized, data))
+			return true;
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+	data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return true;
+}
+
+/**
+ * @brief Reads a whole text file, like a shader or a list of sprites.
+ *
+ * @param path 	- The path of the file
+ * @param text 	- Set to the content of the file
+ * @return true - The file was read
+ */
+bool Vfs::read(const std::string& path, std::string& text)
+{
+	std::vector<unsigned char> data;
+	if (!read(path, data))
+		return false;
+	text.assign(data.begin(), data.end());
+	return true;
+}
@@ -0,0 +1,28 @@
+/**
+ * @file Vfs.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Functions reading the asset files, from the executable, an asset pack or the disk.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <string>
+#include <vector>
+
+/**
+ * @brief 	Where every asset is read through. A path (e.g. "res/maze.png") is looked up in
+ * 			the files embedded into the executable first (EMBED_ASSETS), then in the mounted
+ * 			asset packs, the last mounted first, and last in the working directory. Packs
+ * 			are mounted once at startup, reading from several threads is safe after that.
+ */
+namespace Vfs {
+	bool mount(const std::string& packPath);
+	void unmountAll();
+
+	bool exists(const std::string& path);
+	bool read(const std::string& path, std::vector<unsigned char>& data);
+	bool read(const std::string& path, std::string& text);
+}
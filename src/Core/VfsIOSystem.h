@@ -0,0 +1,55 @@
+/**
+ * @file VfsIOSystem.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Lets Assimp read the models and their materials through the Vfs.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "Vfs.h"
+
+#include <assimp/IOSystem.hpp>
+#include <assimp/MemoryIOWrapper.h>
+
+#include <cstring>
+#include <vector>
+
+/**
+ * @class VfsIOSystem
+ * @brief 	Assimp opens the .obj and then every .mtl it refers to through this, so a model
+ * 			in the asset pack is loaded without touching the disk. Every file is read whole
+ * 			and handed to Assimp from memory.
+ */
+class VfsIOSystem : public Assimp::IOSystem
+{
+public:
+	bool Exists(const char* pFile) const override
+	{
+		return Vfs::exists(pFile);
+	}
+
+	char getOsSeparator() const override
+	{
+		return '/';
+	}
+
+	Assimp::IOStream* Open(const char* pFile, const char* pMode = "rb") override
+	{
+		if (std::strchr(pMode, 'w') != nullptr)
+			return nullptr;
+		std::vector<unsigned char> data;
+		if (!Vfs::read(pFile, data))
+			return nullptr;
+		uint8_t* buffer = new uint8_t[data.size()];
+		std::memcpy(buffer, data.data(), data.size());
+		return new Assimp::MemoryIOStream(buffer, data.size(), true);
+	}
+
+	void Close(Assimp::IOStream* pFile) override
+	{
+		delete pFile;
+	}
+};
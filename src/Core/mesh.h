@@ -38,6 +38,7 @@ public:
     vector<unsigned int> indices;
     vector<sTexture>      textures;
     unsigned int VAO;
+    GLenum indexType;   // GL_UNSIGNED_SHORT when every index fits in one, else GL_UNSIGNED_INT
 
     // constructor
     Mesh(vector<sVertex> vertices, vector<unsigned int> indices, vector<sTexture> textures)
@@ -81,7 +82,7 @@ public:
 
         // draw mesh
         glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+        glDrawElements(GL_TRIANGLES, indices.size(), indexType, 0);
         glBindVertexArray(0);
 
         // always good practice to set everything back to defaults once configured.
@@ -108,8 +109,19 @@ private:
         // again translates to 3/2 floats which translates to a byte array.
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(sVertex), &vertices[0], GL_STATIC_DRAW);
 
+        // the indices of most models fit in unsigned shorts, which halves their size
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+        if (vertices.size() <= 65536)
+        {
+            vector<unsigned short> shortIndices(indices.begin(), indices.end());
+            indexType = GL_UNSIGNED_SHORT;
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, shortIndices.size() * sizeof(unsigned short), &shortIndices[0], GL_STATIC_DRAW);
+        }
+        else
+        {
+            indexType = GL_UNSIGNED_INT;
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+        }
 
         // set the vertex attribute pointers
         // vertex Positions
@@ -12,6 +12,8 @@
 #include "stb_image.h"
 #include "shader.h"
 #include "mesh.h"
+#include "Vfs.h"
+#include "VfsIOSystem.h"
 
 #include <string>
 #include <fstream>
@@ -49,8 +51,9 @@ private:
     // loads a model with supported ASSIMP extensions from file and stores the resulting meshes in the meshes vector.
     void loadModel(string const& path)
     {
-        // read file via ASSIMP
+        // read file via ASSIMP, through the Vfs so the model and its materials can come from the asset pack
         Assimp::Importer importer;
+        importer.SetIOHandler(new VfsIOSystem);
         const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
         // check for errors
         if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
@@ -209,7 +212,10 @@ private:
         glGenTextures(1, &textureID);
 
         int width, height, nrComponents;
-        unsigned char* data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
+        unsigned char* data = nullptr;
+        vector<unsigned char> file;
+        if (Vfs::read(filename, file))
+            data = stbi_load_from_memory(file.data(), (int)file.size(), &width, &height, &nrComponents, 0);
         if (data)
         {
             GLenum format;
@@ -22,9 +22,10 @@
  * @param renderer 		- The Ghost's renderer
  * @param ID 			- The Ghost's identifier in the level
  * @param spritePaths 	- The path to the file containing the paths to the rest of the sprites.
+ * @param ghost 		- The simulated ghost this sprite follows.
  */
 Ghost::Ghost(Maze3D* maze, Shader* shader, Renderer* renderer, const int ID,
-			 const std::string spritePaths, Ghost3D* ghost)
+			 const std::string spritePaths, const SimGhost* ghost)
 	:	MovableObject(maze,shader,renderer,ID,spritePaths),
 		m_Ghost(ghost)
 {
@@ -33,7 +34,7 @@ Ghost::Ghost(Maze3D* maze, Shader* shader, Renderer* renderer, const int ID,
 }
 
 /**
- * @brief Sets a direction based on the corresponding 3d ghost's direction
+ * @brief Sets a direction based on the corresponding simulated ghost's direction
  */
 void Ghost::setDirection()
 {
@@ -56,7 +57,7 @@ void Ghost::setDirection()
 }
 
 /**
- * @brief Sets a new position on the minimap based on the corresponding 3d ghost's position
+ * @brief Sets a new position on the minimap based on the corresponding simulated ghost's position
  * 
  * @param dt 
  */
@@ -10,7 +10,7 @@
  */
 #pragma once
 #include "MovableObject.h"
-#include "../Maze3D/Ghost3D.h"
+#include "../Sim/GameSim.h"
 
 /**
  * @brief Enum for determining what axis a ghost is currently moving in.
@@ -30,7 +30,7 @@ enum Axis
 class Ghost : public MovableObject
 {
 public:
-	Ghost(Maze3D* maze, Shader* shader, Renderer* renderer, const int ID, const std::string spritePaths, Ghost3D* ghost);
+	Ghost(Maze3D* maze, Shader* shader, Renderer* renderer, const int ID, const std::string spritePaths, const SimGhost* ghost);
 
 	virtual void setDirection();
 	virtual void setPosition(float dt);
@@ -41,5 +41,5 @@ private:
 			prevPosY;
 	int		dir;
 
-	Ghost3D* m_Ghost;
+	const SimGhost* m_Ghost;
 };
@@ -9,6 +9,8 @@
  * 
  */
 #include "Maze.h"
+#include "../Core/CompiledLevel.h"
+#include "../Core/LevelGeometry.h"
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
 
@@ -19,7 +21,6 @@
  * @param shader 	  - The maze's shader
  * @param renderer 	  - The maze's renderer
  * 
- * @see	make2dArray();
  * @see	generateMaze();
  */
 Maze::Maze(ScenarioLoader* loadedLevel, Shader* shader, Renderer* renderer)
@@ -30,9 +31,9 @@ Maze::Maze(ScenarioLoader* loadedLevel, Shader* shader, Renderer* renderer)
 {
 	width = m_LoadedLevel->getHorizontalSize();
 	height = m_LoadedLevel->getVerticalSize();
+	m_Grid = m_LoadedLevel->getGrid();	//read in place, the loader outlives the maze
+	window = makeMinimapWindow(width, height, 0.f, 0.f);
 
-	map2d.resize(height, std::vector<int>(width));
-	make2dArray();
 	generateMaze();
 	countPellets();
 }
@@ -49,86 +50,80 @@ Maze::~Maze(){
 }
 
 /**
- * @brief Converts the 1D vector of the map from the ScenarioLoader into a 2D vector. 
- * 
+ * @brief 	Generates the maze, from the generation of the positions/vertices, to the OpenGL stuff.
+ * 			A level compiled by levelc already has the indices, they are uploaded straight from it.
+ * @see makeWindow();
  */
-void Maze::make2dArray()
+void Maze::generateMaze()
 {
-	int index = 0;
-	for (int i = 0; i < height; i++)
-	{
-		for (int j = 0; j < width; j++)
-		{
-			map2d[i][j] = m_LoadedLevel->mazeMap[index++];
-		}
+	const CompiledLevel* compiled = m_LoadedLevel->getCompiledLevel();
+	size_t indexCount = 0;
+	const unsigned int* indices = compiled ? compiled->getSection<unsigned int>(LevelSection::MinimapIndices, indexCount) : nullptr;
+	if (indices == nullptr) {
+		makeWindow();
+		indices = mazeIndices.data();
+		indexCount = mazeIndices.size();
 	}
-}
-
-/**
- * @brief Generates the indices for each square in the maze.
- * 
- */
-void Maze::makeIndices()
-{
-	//Since we require +1 more indices than the amount of squares it is incremented.
-	int indicesHeigth = height + 1; int indicesWidth = width + 1;
-
-	for (int i = 0; i < indicesHeigth; i++) {
-		for (int j = 0; j < indicesWidth; j++) {
-			if (i < map2d.size() && j < map2d[i].size() && map2d[i][j] == 1) {
-						mazeIndices.push_back((i * indicesWidth) + j);
-						mazeIndices.push_back((i * indicesWidth) + j + 1);
-						mazeIndices.push_back(((i + 1) * indicesWidth) + j);
-
-						mazeIndices.push_back((i * indicesWidth) + j + 1);
-						mazeIndices.push_back(((i + 1) * indicesWidth) + j);
-						mazeIndices.push_back(((i + 1) * indicesWidth) + (j + 1));
-			}
-		}
+	else {
+		mazePositions.clear();
+		makeMinimapPositions(window, mazePositions);
 	}
-}
-
-/**
- * @brief Generates positions to be used by the squares.
- * 
- */
-void Maze::makePositions()
-{
-	int index = 0;
-	for (int y = 0; y < height + 1; y++) {
-		for (int x = 0; x < width + 1; x++) {
-			mazePositions.push_back(glm::vec3(x, y, 0));
-		}
-	}
-}
-
-/**
- * @brief Generates the maze, from the generation of the positions/vertices, to the OpenGL stuff. 
- * @see makePositions();
- * @see makeIndices();
- */
-void Maze::generateMaze()
-{
-	makePositions();
-	makeIndices();
 
 	mazeVAO = new VertexArray;
 	mazeVAO->Bind();
-	mazeVBO = new VertexBuffer(&mazePositions[0], mazePositions.size() * sizeof(glm::vec3));
+	mazeVBO = new VertexBuffer(mazePositions.data(), mazePositions.size() * sizeof(glm::vec3));
 	mazeVBO->Bind();
 	mazeVBLayout = new VertexBufferLayout;
 	mazeVBLayout->Push<float>(3);
 	mazeVAO->AddBuffer(*mazeVBO, *mazeVBLayout);
 
-	mazeIBO = new IndexBuffer(&mazeIndices[0], mazeIndices.size());
+	mazeIBO = new IndexBuffer(indices, indexCount);
 
 	m_Shader->use();
 	m_Shader->setVec4("u_Color", 0.f, 0.125f, 0.76f, 1.f);
 }
 
-void Maze::camera(int hSize, int vSize)
+/**
+ * @brief Makes the positions and indices of the tiles in the window.
+ * @see makeMinimapPositions();
+ * @see makeMinimapIndices();
+ */
+void Maze::makeWindow()
+{
+	mazePositions.clear();
+	mazeIndices.clear();
+	makeMinimapPositions(window, mazePositions);
+	makeMinimapIndices(m_Grid, window, mazeIndices);
+}
+
+/**
+ * @brief 	Moves the window of a streamed level along with the player, the maze of the
+ * 			new window is uploaded in place of the old. Does nothing on other levels.
+ *
+ * @param x 		- The x coordinate of the player
+ * @param y 		- The y coordinate (z in the 3d maze) of the player
+ * @return true 	- The window moved
+ */
+bool Maze::follow(float x, float y)
+{
+	MinimapWindow next = makeMinimapWindow(width, height, x, y);
+	if (next == window)
+		return false;
+
+	window = next;
+	makeWindow();
+	mazeVAO->changeData(mazeVBO, mazePositions.data(), mazePositions.size() * sizeof(glm::vec3));
+	mazeIBO->selectIndices(mazeIndices.data(), mazeIndices.size());
+	return true;
+}
+
+/**
+ * @brief Sets the view projection, showing the tiles of the window.
+ *
+ */
+void Maze::camera()
 {
-	glm::mat4 projection = glm::ortho(0.f, (float)hSize, (float)vSize, 0.f);
+	glm::mat4 projection = glm::ortho((float)window.x, (float)(window.x + window.width), (float)(window.y + window.height), (float)window.y);
 
 	glm::mat4 view = glm::lookAt(glm::vec3(0, 0, 1), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
 
@@ -139,12 +134,12 @@ void Maze::camera(int hSize, int vSize)
 }
 
 /**
- * @brief Counts how many !1 occour in the maze, counting how many "pellets" exists
+ * @brief Counts how many tiles are neither a wall nor an EMPTY_TILE, counting how many "pellets" exists
 */
 void Maze::countPellets()
 {
-	for (int i = 0; i < m_LoadedLevel->mazeMap.size(); i++)
-		if (m_LoadedLevel->mazeMap[i] != 1)
+	for (int i = 0; i < width * height; i++)
+		if (m_Grid[i] != 1 && m_Grid[i] != EMPTY_TILE)
 			pelletCount++;
 }
 
@@ -155,6 +150,6 @@ void Maze::countPellets()
 void Maze::draw()
 {
 	m_Shader->use();
-	camera(width, height);
+	camera();
 	m_Renderer->Draw(mazeVAO, mazeIBO, m_Shader);
 }
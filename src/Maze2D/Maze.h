@@ -16,6 +16,7 @@
 #include "../Core/IndexBuffer.h"
 #include "../Core/Renderer.h"
 #include "../Core/shader.h"
+#include "../Core/LevelGeometry.h"
 
 /**
  * @class Maze
@@ -29,6 +30,8 @@ private:
 		pelletCount;
 
 	ScenarioLoader* m_LoadedLevel;
+	MazeGrid m_Grid;
+	MinimapWindow window;	//the tiles drawn, the whole level unless it is streamed
 	std::vector <unsigned int> mazeIndices;
 	std::vector <glm::vec3> mazePositions;
 
@@ -41,22 +44,21 @@ private:
 	IndexBuffer*		mazeIBO;
 public:
 
-	std::vector<std::vector<int>> map2d;
-
 	Maze(ScenarioLoader* loadedLevel, Shader* shader, Renderer* renderer);
 	~Maze();
 
 	void draw();
+	bool follow(float x, float y);
+	inline MinimapWindow getWindow() const { return window; }
 	inline std::vector <glm::vec3> getMazePositions() { return mazePositions; }
 	inline int getHeight()	{ return height; }
 	inline int getWidth()	{ return width; }
 	inline int getPelletCount() { return pelletCount; }
+	inline int getTile(int y, int x) const { return m_Grid(y, x); }
 
 private:
 	void countPellets();
-	void make2dArray();
-	void makeIndices();
-	void makePositions();
 	void generateMaze();
-	void camera(int hSize, int vSize);
+	void makeWindow();
+	void camera();
 };
@@ -76,16 +76,17 @@ void MovableObject::generateMovableObject()
 /**
  * @brief Draws the MovableObject
  * 
+ * @param window - The tiles the minimap shows
  */
-void MovableObject::draw()
+void MovableObject::draw(MinimapWindow window)
 {
-	camera(width, height);
+	camera(window);
 	m_Renderer->Draw(movableObjectVAO, movableObjectIBO, m_Shader);
 }
 
-void MovableObject::camera(int hSize, int vSize)
+void MovableObject::camera(MinimapWindow window)
 {
-		glm::mat4 projection = glm::ortho(0.f, (float)hSize, (float)vSize, 0.f);
+		glm::mat4 projection = glm::ortho((float)window.x, (float)(window.x + window.width), (float)(window.y + window.height), (float)window.y);
 
 		glm::mat4 view = glm::lookAt(glm::vec3(0, 0, 1), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
 
@@ -114,7 +115,7 @@ void MovableObject::generateMovableObjectVertices()
 {
 	for (int y = 0; y < height; y++)
 		for (int x = 0; x < width; x++)
-			if (m_Maze->map2d[y][x] == mapID)
+			if (m_Maze->getTile(y, x) == mapID)
 			{
 				posY = startY = y; posX = startX = x;
 				movableObjectVertices.push_back(glm::vec3(x, y, 0.f));     //position
@@ -128,7 +129,6 @@ void MovableObject::generateMovableObjectVertices()
 
 				movableObjectVertices.push_back(glm::vec3(x + 1, y + 1, 0.f));	//position
 				movableObjectVertices.push_back(glm::vec3(1.f, 0.f, 0.f));		//texture
-				m_Maze->map2d[y][x] = 0; //marks the location of the entity for pellet rendering
 			}
 }
 
@@ -69,8 +69,8 @@ public:
 	~MovableObject();
 	
 	void generateMovableObject();
-	void draw();
-	void camera(int hSize, int vSize);
+	void draw(MinimapWindow window);
+	void camera(MinimapWindow window);
 	virtual void setPosition(float dt);
 	virtual void setDirection() = 0;
 
@@ -17,22 +17,24 @@
 /**
  * @brief Construct a new Pellets:: Pellets object
  * 
- * @param maze 		- The maze the pellets are to be drawn in
+ * @param sim 		- The game simulation owning the pellets
  * @param shader 	- The Pellet's shader
  * @param renderer 	- The Pellet's renderer
  * @param player 	- The player responsible for "eating" the pellets. 
  * 
  * @see generatePellets()
  */
-Pellets::Pellets(Maze3D* maze, Shader* shader, Renderer* renderer/*, Camera* player*/)
-	:	m_Maze(maze),
+Pellets::Pellets(const GameSim* sim, Shader* shader, Renderer* renderer/*, Camera* player*/)
+	:	m_Sim(sim),
 		m_Renderer(renderer),
 		m_Shader(shader),
 		/*m_Player(player),*/
-		allPelletsEaten(false)
+		allPelletsEaten(false),
+		pelletGeneration(0),
+		window(makeMinimapWindow(sim->getWidth(), sim->getHeight(), 0.f, 0.f))
 {
 	generatePellets();
-	remainingPellets = m_Maze->getPelletCount();
+	remainingPellets = m_Sim->getRemainingPellets();
 }
 
 /**
@@ -42,7 +44,6 @@ Pellets::Pellets(Maze3D* maze, Shader* shader, Renderer* renderer/*, Camera* pla
 Pellets::~Pellets()
 {
 		
-	free(m_Maze);
 	free(m_Renderer);
 	free(m_Shader);
 	free(pelletsVAO);
@@ -68,14 +69,14 @@ void Pellets::generatePellets()
 
 	pelletsVAO = new VertexArray;
 	pelletsVAO->Bind();
-	pelletsVBO = new VertexBuffer(&pelletVertices[0], pelletVertices.size() * sizeof(glm::vec3));
+	pelletsVBO = new VertexBuffer(pelletVertices.data(), pelletVertices.size() * sizeof(glm::vec3));
 	pelletsVBO->Bind();
 	pelletsVBLayout = new VertexBufferLayout;
 	pelletsVBLayout->Push<float>(3);
 	pelletsVBLayout->Push<float>(3);
 	pelletsVAO->AddBuffer(*pelletsVBO, *pelletsVBLayout);
 
-	pelletsIBO = new IndexBuffer(&pelletsIndices[0], pelletsIndices.size());
+	pelletsIBO = new IndexBuffer(pelletsIndices.data(), pelletsIndices.size());
 
 	//m_Shader->createShaderProgram();
 	//m_Shader->setUniform4f("u_Color",.1f, .1f, .1f, 1.f);
@@ -88,29 +89,23 @@ void Pellets::generatePellets()
 }
 
 /**
- * @brief Generates the indices for each pellet.
+ * @brief Generates the indices for each pellet in the window.
  * 
  */
 void Pellets::makePelletsIndices()
 {
-
-	int indicesHeigth = m_Maze->getHeight(); int indicesWidth = m_Maze->getWidth();
-
-	for (int i = 0; i < indicesHeigth; i++) {
-		for (int j = 0; j < indicesWidth; j++) {
-			if (i < m_Maze->map2d.size() && j < m_Maze->map2d[i].size() && m_Maze->map2d[i][j] == 0) {
-
-				int k = (i * indicesWidth + j) * 4;
+	pelletsIndices.clear();
+	for (int y = window.y; y < window.y + window.height; y++)
+		for (int x = window.x; x < window.x + window.width; x++)
+			if (m_Sim->getPelletAt(y, x) != -1) {
+				int k = ((y - window.y) * window.width + x - window.x) * 4;
 				pelletsIndices.push_back(k);
 				pelletsIndices.push_back(k + 1);
 				pelletsIndices.push_back(k + 2);
 				pelletsIndices.push_back(k + 1);
 				pelletsIndices.push_back(k + 2);
 				pelletsIndices.push_back(k + 3);
-
 			}
-		}
-	}
 }
 
 /**
@@ -122,19 +117,32 @@ void Pellets::draw()
 	m_Shader->use();
 	pelletsTexture->Bind(0);
 	hasBeenEaten();
-	camera(m_Maze->getWidth(), m_Maze->getHeight());
+	camera();
 	m_Renderer->Draw(pelletsVAO, pelletsIBO, m_Shader);
 }
 
 /**
- * @brief Sets the view projection for the pellets
+ * @brief 	Moves the window of a streamed level, the pellets of the new window are uploaded
+ * 			in place of the old.
+ *
+ * @param window - The tiles to draw, the same as the maze's
+ */
+void Pellets::setWindow(MinimapWindow window)
+{
+	this->window = window;
+	makeVertices();
+	makePelletsIndices();
+	hasBeenEaten(true);
+	pelletsIBO->selectIndices(pelletsIndices.data(), pelletsIndices.size());
+}
+
+/**
+ * @brief Sets the view projection for the pellets, showing the tiles of the window
  * 
- * @param hSize - Horizontal size
- * @param vSize - Vertical size
  */
-void Pellets::camera(int hSize, int vSize)
+void Pellets::camera()
 {
-		glm::mat4 projection = glm::ortho(0.f, (float)hSize, (float)vSize, 0.f);
+		glm::mat4 projection = glm::ortho((float)window.x, (float)(window.x + window.width), (float)(window.y + window.height), (float)window.y);
 
 		glm::mat4 view = glm::lookAt(glm::vec3(0, 0, 1), glm::vec3(0, 0, 0), glm::vec3(0, 1, 0));
 
@@ -143,13 +151,14 @@ void Pellets::camera(int hSize, int vSize)
 }
 
 /**
- * @brief Makes all the vertices for the pellets, including positions and texture coordinates. 
+ * @brief Makes all the vertices for the pellets in the window, including positions and texture coordinates. 
  * 
  */
 void Pellets::makeVertices()
 {
-		for (int y = 0; y < m_Maze->getHeight(); y++) {
-			for (int x = 0; x < m_Maze->getWidth(); x++) {
+		pelletVertices.clear();
+		for (int y = window.y; y < window.y + window.height; y++) {
+			for (int x = window.x; x < window.x + window.width; x++) {
 				pelletVertices.push_back(glm::vec3(x, y, 0.f));     //position
 				pelletVertices.push_back(glm::vec3(0.f, 1.f, 0.f)); //texture
 				
@@ -168,20 +177,28 @@ void Pellets::makeVertices()
 /**
  * @brief Checks wheter or not a pellet has been "eaten" by pacman (the player).
  *		  If the pellet has been eaten, the texture for the given pellet is set to 0
+ *
+ * @param force - Checks the pellets of the window even if none was eaten since the last time
  */
-void Pellets::hasBeenEaten()
+void Pellets::hasBeenEaten(bool force)
 {
-	int height = m_Maze->getHeight(); int width = m_Maze->getWidth();
-	for (int y = 0; y < height; y++)
-		for (int x = 0; x < width; x++)
-			if (m_Maze->map2d[y][x] == 9) {
-				int i = (y * m_Maze->getWidth() + x) * 8;
+	if (pelletGeneration == m_Sim->getPelletGeneration() && !force)
+		return;
+	pelletGeneration = m_Sim->getPelletGeneration();
+
+	const auto& pellets = m_Sim->getPellets();
+	for (int y = window.y; y < window.y + window.height; y++)
+		for (int x = window.x; x < window.x + window.width; x++) {
+			int pellet = m_Sim->getPelletAt(y, x);
+			if (pellet != -1 && pellets[pellet].eaten) {
+				int i = ((y - window.y) * window.width + x - window.x) * 8;
 				pelletVertices[i + 1] = glm::vec3(0.f); //sets the textures for the "eaten" object to null.
 				pelletVertices[i + 3] = glm::vec3(0.f);
 				pelletVertices[i + 5] = glm::vec3(0.f);
 				pelletVertices[i + 7] = glm::vec3(0.f);
 			}
-	pelletsVAO->changeData(pelletsVBO, &pelletVertices[0], pelletVertices.size() * sizeof(glm::vec3));
-		if (--remainingPellets == 0)
-			allPelletsEaten = true;
+		}
+	pelletsVAO->changeData(pelletsVBO, pelletVertices.data(), pelletVertices.size() * sizeof(glm::vec3));
+	remainingPellets = m_Sim->getRemainingPellets();
+	allPelletsEaten = m_Sim->allPelletsEaten();
 }
@@ -10,6 +10,7 @@
  */
 #pragma once
 #include "../Maze3D/Maze3D.h"
+#include "../Sim/GameSim.h"
 #include "Pacman.h"
 #include "../Core/Texture.h"
 
@@ -23,10 +24,12 @@ class Pellets
 private:
 	int  remainingPellets;
 	bool allPelletsEaten;
+	unsigned int pelletGeneration;
+	MinimapWindow window;	//the tiles drawn, the whole level unless it is streamed
 	std::vector <unsigned int>	pelletsIndices;
 	std::vector <glm::vec3>		pelletVertices;
 	
-	Maze3D*				m_Maze;
+	const GameSim*		m_Sim;
 	Renderer*			m_Renderer;
 	Shader*				m_Shader;
 
@@ -38,16 +41,17 @@ private:
 
 	/*Camera*				m_Player;*/
 public:
-	Pellets(Maze3D* maze, Shader* shader, Renderer* renderer/*, Camera* player*/);
+	Pellets(const GameSim* sim, Shader* shader, Renderer* renderer/*, Camera* player*/);
 	~Pellets();
 
 	void generatePellets();
 	void makePelletsIndices();
 	void draw();
-	void camera(int hSize, int vSize);
+	void setWindow(MinimapWindow window);
+	void camera();
 	void makeVertices();
 	bool allPelletsGone() { return allPelletsEaten; }
 	int  getScore() { return remainingPellets; }
 private:
-	void hasBeenEaten();
+	void hasBeenEaten(bool force = false);
 };
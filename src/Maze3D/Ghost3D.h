@@ -9,47 +9,25 @@
  * 
  */
 #pragma once
-#include "../Core/AStar.h"
+#include "../Sim/GameSim.h"
+#include "Maze3D.h"
 #include "../Core/model.h"
-
-/**
- * @brief Enum for specifying what direction (to be moved in) / (are moving in)
- * 
- */
-enum Direction {
-	North = 0,
-	South = 1,
-	East  = 2,
-	West  = 3
-};
+#include "../Core/GridVisibility.h"
 
 /**
  * @class Ghost3D 
- * @brief The code for handling everyting related to the 3d Ghosts. 
+ * @brief 	The code for drawing the 3d Ghosts. The ghost's position and movement
+ * 			is owned by the GameSim, this class only reads from it.
  */
 class Ghost3D
 {
 public:
-	Ghost3D(Model* ghostModel, Maze3D* maze, int ghostID, Camera* player, AStar* pathfinder);
+	Ghost3D(Model* ghostModel, const SimGhost* ghost);
 
-	void Draw(Shader* shader, glm::mat4 projection, glm::mat4 view, float dt, bool constrainMovement);
+	void Draw(Shader* shader, glm::mat4 projection, glm::mat4 view, const GridVisibility* visibility = nullptr);
 	
-	float posX, posY;
-	Direction direction;
-	bool playerEaten;
+	const SimGhost* getState() const { return m_State; }
 private:
-	int m_ID;
-	float movementSpeed;
-	float rotationAngle;
-	bool  firstDirection, beenAdjusted;
-	Camera* m_Player;
-	Maze3D* m_Maze;
-	Model*	m_Ghost;
-
-
-	void setSpawn();
-
-	AStar* m_Pathfinder;
-	void Move(float dt, bool constrainMovement);
-	void Translate(Direction dir, float dt);
-};
\ No newline at end of file
+	Model*			m_Ghost;
+	const SimGhost*	m_State;
+};
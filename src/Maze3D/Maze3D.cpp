@@ -11,6 +11,7 @@
 
 #include "Maze3D.h"
 #include "../Core/ScenarioLoader.h"
+#include "../Core/CompiledLevel.h"
 
 #include "../Core/VertexBuffer.h"
 #include "../Core/IndexBuffer.h"
@@ -26,7 +27,6 @@
   * @param shader 	  	- The Maze3D's shader
   * @param renderer 	- The Maze3D's renderer
   *
-  * @see	make2dArray();
   * @see	generateMaze3D();
   * @see	countPellets();
   */
@@ -34,13 +34,15 @@ Maze3D::Maze3D(ScenarioLoader* loadedLevel, Shader* shader, Renderer* renderer)
 	: m_LoadedLevel(loadedLevel),
 	m_Renderer(renderer),
 	m_Shader(shader),
-	pelletCount(0)
+	pelletCount(0),
+	drawnTriangles(0),
+	chunks(nullptr)
 {
 	width = m_LoadedLevel->getHorizontalSize();
 	height = m_LoadedLevel->getVerticalSize();
+	m_Grid = m_LoadedLevel->getGrid();	//read in place, the loader outlives the maze
+	visibility = new GridVisibility(m_Grid);
 
-	map2d.resize(height, std::vector<int>(width));
-	make2dArray();
 	generateMaze3D();
 	countPellets();
 }
@@ -54,39 +56,8 @@ Maze3D::~Maze3D() {
 	free(Maze3DVBO);
 	free(Maze3DVBLayout);
 	free(Maze3DIBO);
-}
-
-/**
- * @brief Converts the 1D vector of the map from the ScenarioLoader into a 2D vector.
- *
- */
-void Maze3D::make2dArray()
-{
-	int index = 0;
-	for (int i = 0; i < height; i++)
-	{
-		for (int j = 0; j < width; j++)
-		{
-			map2d[i][j] = m_LoadedLevel->mazeMap[index++];
-		}
-	}
-}
-
-
-/**
- * @brief Loops through the maze to find the players spawning point.
- * 
- * @return glm::vec3 
- */
-glm::vec3 Maze3D::findSpawn()
-{
-	for (int y = 0; y < height; y++)
-		for (int x = 0; x < width; x++)
-			if (map2d[y][x] == 2)
-			{
-				return glm::vec3((float)x+.5f,0.5f,(float)y+.5f);
-			}
-				
+	delete chunks;
+	delete visibility;
 }
 
 /**
@@ -134,286 +105,58 @@ void Maze3D::Transform(float dt)
 }
 
 /**
- * @brief Generates the indices for each square in the Maze3D.
- *
+ * @brief 	Generates the Maze3D, from the generation of the positions/vertices, to the OpenGL stuff.
+ * 			A level compiled by levelc already has the vertices, indices and chunks, they are
+ * 			uploaded straight from it. The walls of a level too large for that are streamed in chunks
+ * 			around the camera, only the floor is uploaded here.
+ * @see makeMazeMesh();
  */
-void Maze3D::makeIndices()
+void Maze3D::generateMaze3D()
 {
-
-	//Indices for the plane under the maze
-	Maze3DIndices.push_back(0); 
-	Maze3DIndices.push_back(1);
-	Maze3DIndices.push_back(2);
-	Maze3DIndices.push_back(1);
-	Maze3DIndices.push_back(2);
-	Maze3DIndices.push_back(3);
-
-	for (int i = 0; i < height; i++) {
-		for (int j = 0; j < width; j++) {
-			if (i < map2d.size() && j < map2d[i].size() && map2d[i][j] == 1) {
-				int k = 4 + (i * width + j) * 24;
-				
-
-				/*
-				The top and bottom have been removed by performance reasons,
-				still left in code in case anyone would like to re add them. 
-				//Bottom
-				Maze3DIndices.push_back(k);
-				Maze3DIndices.push_back(k + 1);
-				Maze3DIndices.push_back(k + 2);
-				Maze3DIndices.push_back(k + 1);
-				Maze3DIndices.push_back(k + 2);
-				Maze3DIndices.push_back(k + 3);
-				//Top
-				Maze3DIndices.push_back(k + 4);
-				Maze3DIndices.push_back(k + 5);
-				Maze3DIndices.push_back(k + 6);
-				Maze3DIndices.push_back(k + 5);
-				Maze3DIndices.push_back(k + 6);
-				Maze3DIndices.push_back(k + 7);
-				
-				*/
-
-				if (j + 1 < width)
-					//Right
-					if (map2d[i][j + 1] != 1) {
-					Maze3DIndices.push_back(k + 8);
-					Maze3DIndices.push_back(k + 9);
-					Maze3DIndices.push_back(k + 10);
-					Maze3DIndices.push_back(k + 9);
-					Maze3DIndices.push_back(k + 10);
-					Maze3DIndices.push_back(k + 11);
-					}
-				
-				if (j - 1 >= 0)
-					if (map2d[i][j - 1] != 1) {
-					//Left
-					Maze3DIndices.push_back(k + 12);
-					Maze3DIndices.push_back(k + 13);
-					Maze3DIndices.push_back(k + 14);
-					Maze3DIndices.push_back(k + 13);
-					Maze3DIndices.push_back(k + 14);
-					Maze3DIndices.push_back(k + 15);
-					}
-
-				if (i - 1 >= 0)
-					if (map2d[i - 1][j] != 1) {
-					//Back
-					Maze3DIndices.push_back(k + 16);
-					Maze3DIndices.push_back(k + 17);
-					Maze3DIndices.push_back(k + 18);
-					Maze3DIndices.push_back(k + 17);
-					Maze3DIndices.push_back(k + 18);
-					Maze3DIndices.push_back(k + 19);
-					}
-
-
-				if (i + 1 < height)
-					if (map2d[i + 1][j] != 1) {
-					//Front
-					Maze3DIndices.push_back(k + 20);
-					Maze3DIndices.push_back(k + 21);
-					Maze3DIndices.push_back(k + 22);
-					Maze3DIndices.push_back(k + 21);
-					Maze3DIndices.push_back(k + 22);
-					Maze3DIndices.push_back(k + 23);
-					}
-				
-			}
-		}
+	const CompiledLevel* compiled = m_LoadedLevel->getCompiledLevel();
+	size_t vertexCount = 0, indexCount = 0;
+	const Vertex* vertices = compiled ? compiled->getSection<Vertex>(LevelSection::MazeVertices, vertexCount) : nullptr;
+	const unsigned int* indices = compiled ? compiled->getSection<unsigned int>(LevelSection::MazeIndices, indexCount) : nullptr;
+	size_t chunkCount = 0;
+	const MeshChunk* meshChunks = compiled ? compiled->getSection<MeshChunk>(LevelSection::MazeChunks, chunkCount) : nullptr;
+	if (isStreamedLevel(width, height)) {
+		makeMazeFloor(width, height, Maze3DVertex, Maze3DIndices);
+		vertices = Maze3DVertex.data();
+		vertexCount = Maze3DVertex.size();
+		indices = Maze3DIndices.data();
+		indexCount = Maze3DIndices.size();
+		chunks = new MazeChunks(m_Grid);
 	}
-}
-
-/**
- * @brief Generates positions to be used by the squares.
- *
- */
-void Maze3D::makeVertices()
-{
-
-	//making the floor +2 bigger than the maze in size to make sure it covers it all.
-	Vertex vertex;
-	//Plane / Floor for the maze:
-	vertex.position = glm::vec3(-2.f, -0.1f, -2.f);
-	vertex.normal = glm::vec3(0, 1.0f, 0);
-	vertex.textureCoord = glm::vec2(0.0f, 0.0f);
-	Maze3DVertex.push_back(vertex);
-
-	vertex.position = glm::vec3(width+2.f, -0.1f, -2.f);
-	vertex.normal = glm::vec3(width+2.f, 1.0f, -2.f);
-	vertex.textureCoord = glm::vec2(1.0f, 0.0f);
-	Maze3DVertex.push_back(vertex);
-
-	vertex.position = glm::vec3(-2.f, -0.1f, height+2.f);
-	vertex.normal = glm::vec3(-2.f, 1.0f, height+2.f);
-	vertex.textureCoord = glm::vec2(0.0f, 1.0f);
-	Maze3DVertex.push_back(vertex);
-
-	vertex.position = glm::vec3(width+2.f, -0.1f, height+2.f);
-	vertex.normal = glm::vec3(width+2.f, 1.0f, height+2.f);
-	vertex.textureCoord = glm::vec2(1.0f, 1.0f);
-	Maze3DVertex.push_back(vertex);
-
-	for (int z = 0; z < height; z++) {
-		for (int x = 0; x < width; x++) {
-				//Bottom
-				vertex.position		= glm::vec3(x,		0.0f, z);		
-				vertex.normal		= glm::vec3(x,		-1.0f, z);		
-				vertex.textureCoord = glm::vec2(0.0f,	0.0f);			
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x + 1,	0.0f, z);		
-				vertex.normal		= glm::vec3(x + 1,	-1.0f, z);		
-				vertex.textureCoord = glm::vec2(1.0f,	0.0f);			
-				Maze3DVertex.push_back(vertex);
-				
-				vertex.position		= glm::vec3(x,		0.0f, z + 1);		
-				vertex.normal		= glm::vec3(x,		-1.0f, z + 1);		
-				vertex.textureCoord = glm::vec2(0.0f,	1.0f);			
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x + 1,	0.0f, z + 1);	
-				vertex.normal		= glm::vec3(x + 1,	-1.0f, z + 1);	
-				vertex.textureCoord = glm::vec2(1.0f,	1.0f);			
-				Maze3DVertex.push_back(vertex);
-
-				//Top
-				vertex.position		= glm::vec3(x,		1.0f, z + 1);
-				vertex.normal		= glm::vec3(x,		2.0f, z + 1);
-				vertex.textureCoord = glm::vec2(0.0f,	0.0f);
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x + 1,	1.0f, z + 1);
-				vertex.normal		= glm::vec3(x + 1,	2.0f, z + 1);
-				vertex.textureCoord = glm::vec2(1.0f,	0.0f);
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x,		1.0f, z);
-				vertex.normal		= glm::vec3(x,		2.0f, z);
-				vertex.textureCoord = glm::vec2(0.0f,	1.0f);
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x + 1,	1.0f, z);
-				vertex.normal		= glm::vec3(x + 1,	2.0f, z);
-				vertex.textureCoord = glm::vec2(1.0f,	1.0f);
-				Maze3DVertex.push_back(vertex);
-
-				//Right
-				vertex.position		= glm::vec3(x + 1,	0.0f, z + 1);
-				vertex.normal		= glm::vec3(x + 2,	0.0f, z + 1);
-				vertex.textureCoord = glm::vec2(0.0f,	0.0f);
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x + 1,	0.0f, z);	
-				vertex.normal		= glm::vec3(x + 2,	0.0f, z);	
-				vertex.textureCoord = glm::vec2(1.0f,	0.0f);		
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x + 1,	1.0f, z + 1);
-				vertex.normal		= glm::vec3(x + 2,	1.0f, z + 1);
-				vertex.textureCoord = glm::vec2(0.0f,	1.0f);		
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x + 1,	1.0f, z);	
-				vertex.normal		= glm::vec3(x + 2,	1.0f, z);	
-				vertex.textureCoord = glm::vec2(1.0f,	1.0f);		
-				Maze3DVertex.push_back(vertex);
-
-				//Left
-				vertex.position		= glm::vec3(x,		0.0f, z);		
-				vertex.normal		= glm::vec3(x - 1,	0.0f, z);	
-				vertex.textureCoord = glm::vec2(0.0f,	0.0f);
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x,		0.0f, z + 1);	
-				vertex.normal		= glm::vec3(x - 1,	0.0f, z + 1);
-				vertex.textureCoord = glm::vec2(1.0f,	0.0f);		
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x,		1.0f, z);		
-				vertex.normal		= glm::vec3(x - 1,	1.0f, z);	
-				vertex.textureCoord = glm::vec2(0.0f,	1.0f);		
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x,		1.0f, z + 1);	
-				vertex.normal		= glm::vec3(x - 1,	1.0f, z + 1);
-				vertex.textureCoord = glm::vec2(1.0f,	1.0f);		
-				Maze3DVertex.push_back(vertex);
-
-				//Back
-				vertex.position		= glm::vec3(x + 1,	0.0f, z);
-				vertex.normal		= glm::vec3(x + 1,	0.0f, z - 1);
-				vertex.textureCoord = glm::vec2(0.0f,	0.0f);
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x,		0.0f, z);
-				vertex.normal		= glm::vec3(x,		0.0f, z - 1);
-				vertex.textureCoord = glm::vec2(1.0f,	0.0f);
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x + 1,	1.0f, z);
-				vertex.normal		= glm::vec3(x + 1,	1.0f, z - 1);
-				vertex.textureCoord = glm::vec2(0.0f,	1.0f);
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x,		1.0f, z);
-				vertex.normal		= glm::vec3(x,		1.0f, z - 1);
-				vertex.textureCoord = glm::vec2(1.0f,	1.0f);
-				Maze3DVertex.push_back(vertex);
-
-				//Front
-				vertex.position		= glm::vec3(x,		0.0f, z + 1);
-				vertex.normal		= glm::vec3(x,		0.0f, z + 2);
-				vertex.textureCoord = glm::vec2(0.0f,	0.0f);
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x + 1,	0.0f, z + 1);
-				vertex.normal		= glm::vec3(x + 1,	0.0f, z + 2);
-				vertex.textureCoord = glm::vec2(1.0f,	0.0f);
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x,		1.0f, z + 1);
-				vertex.normal		= glm::vec3(x,		1.0f, z + 2);
-				vertex.textureCoord = glm::vec2(0.0f,	1.0f);
-				Maze3DVertex.push_back(vertex);
-
-				vertex.position		= glm::vec3(x + 1,	1.0f, z + 1);
-				vertex.normal		= glm::vec3(x + 1,	1.0f, z + 2);
-				vertex.textureCoord = glm::vec2(1.0f,	1.0f);
-				Maze3DVertex.push_back(vertex);
-		}
+	else if (vertices == nullptr || indices == nullptr || meshChunks == nullptr) {
+		makeMazeMesh(m_Grid, Maze3DVertex, Maze3DIndices, Maze3DChunks);
+		vertices = Maze3DVertex.data();
+		vertexCount = Maze3DVertex.size();
+		indices = Maze3DIndices.data();
+		indexCount = Maze3DIndices.size();
 	}
-}
-
-/**
- * @brief Generates the Maze3D, from the generation of the positions/vertices, to the OpenGL stuff.
- * @see makePositions();
- * @see makeIndices();
- */
-void Maze3D::generateMaze3D()
-{
-	makeVertices();
-	makeIndices();
+	else
+		Maze3DChunks.assign(meshChunks, meshChunks + chunkCount);
 
 	Maze3DVAO = new VertexArray;
 	Maze3DVAO->Bind();
-	Maze3DVBO = new VertexBuffer(&Maze3DVertex[0], Maze3DVertex.size() * sizeof(Vertex));
+	Maze3DVBO = new VertexBuffer(vertices, vertexCount * sizeof(Vertex));
 	Maze3DVBO->Bind();
 	Maze3DVBLayout = new VertexBufferLayout;
-	Maze3DVBLayout->Push<float>(3);
-	Maze3DVBLayout->Push<float>(3);
-	Maze3DVBLayout->Push<float>(2);
+	Maze3DVBLayout->PushInteger<unsigned short>(4);	//a packed Vertex
 
 
 	Maze3DVAO->AddBuffer(*Maze3DVBO, *Maze3DVBLayout);
 
-	Maze3DIBO = new IndexBuffer(&Maze3DIndices[0], Maze3DIndices.size());
+	Maze3DIBO = new IndexBuffer(indices, indexCount);
 
 	m_Shader->use();
 
+	//The walls are merged into long quads, the textures repeat once per tile along them
 	Maze3DDiffuse = new Texture("res/maze.png");
+	Maze3DDiffuse->setRepeating();
 	Maze3DDiffuse->Bind(0);
 	Maze3DSpecular = new Texture("res/mazeSpec.png");
+	Maze3DSpecular->setRepeating();
 	Maze3DSpecular->Bind(1);
 	
 	m_Shader->setInt("material.diffuse", 0);
@@ -423,12 +166,12 @@ void Maze3D::generateMaze3D()
 }
 
 /**
- * @brief Counts how many !1 occour in the Maze3D, counting how many "pellets" exists
+ * @brief Counts how many tiles are neither a wall nor an EMPTY_TILE, counting how many "pellets" exists
 */
 void Maze3D::countPellets()
 {
-	for (int i = 0; i < m_LoadedLevel->mazeMap.size(); i++)
-		if (m_LoadedLevel->mazeMap[i] != 1)
+	for (int i = 0; i < width * height; i++)
+		if (m_Grid[i] != 1 && m_Grid[i] != EMPTY_TILE)
 			pelletCount++;
 }
 
@@ -448,5 +191,26 @@ void Maze3D::draw(glm::mat4 projection, glm::mat4 view,const float dt)
 	Transform(dt);
 	Maze3DDiffuse->Bind(0);
 	Maze3DSpecular->Bind(1);
-	m_Renderer->Draw(Maze3DVAO, Maze3DIBO, m_Shader);
+
+	//The maze is drawn where it is, its chunks are culled in world space: outside of the frustum, or with
+	//every tile hidden behind walls. The floor comes first and is always drawn
+	Frustum frustum(projection, view);
+	visibility->update(projection, view);
+	drawCounts.assign(1, 6);
+	drawOffsets.assign(1, nullptr);
+	for (const auto& chunk : Maze3DChunks)
+		if (frustum.intersects(chunk.min, chunk.max) &&
+			visibility->isAreaVisible((int)chunk.min.x, (int)chunk.min.z, (int)chunk.max.x, (int)chunk.max.z)) {
+			drawCounts.push_back((GLsizei)chunk.indexCount);
+			drawOffsets.push_back((const void*)((size_t)chunk.firstIndex * Maze3DIBO->getIndexSize()));
+		}
+	drawnTriangles = 0;
+	for (auto count : drawCounts)
+		drawnTriangles += count / 3;
+	m_Renderer->MultiDraw(Maze3DVAO, Maze3DIBO, m_Shader, drawCounts, drawOffsets);
+
+	if (chunks) {
+		chunks->update(glm::vec3(glm::inverse(view)[3]));
+		drawnTriangles += chunks->draw(m_Renderer, m_Shader, frustum, *visibility);
+	}
 }
@@ -18,16 +18,10 @@
 #include "../Core/Renderer.h"
 #include "../Core/model.h"
 #include "../Core/Texture.h"
-
-/**
- * @brief Struct holding vertex data. 
- * 
- */
-struct Vertex {
-	glm::vec3 position;
-	glm::vec3 normal;
-	glm::vec2 textureCoord;
-};
+#include "../Core/LevelGeometry.h"
+#include "../Core/Frustum.h"
+#include "../Core/GridVisibility.h"
+#include "MazeChunks.h"
  /**
   * @class Maze3D
   * @brief Handles the creation and drawing of the Maze3D.
@@ -40,9 +34,14 @@ private:
 		pelletCount;
 
 	ScenarioLoader* m_LoadedLevel;
+	MazeGrid m_Grid;
 	std::vector <unsigned int> Maze3DIndices;
 	std::vector <glm::vec3> Maze3DVertices;
 	std::vector <Vertex> Maze3DVertex;
+	std::vector <MeshChunk> Maze3DChunks;	//the walls in Maze3DIBO, culled against the view every frame
+	std::vector <GLsizei> drawCounts;			//the ranges of Maze3DIBO drawn this frame, kept to not allocate every frame
+	std::vector <const void*> drawOffsets;
+	int drawnTriangles;
 
 	Renderer* m_Renderer;
 
@@ -52,10 +51,11 @@ private:
 	IndexBuffer* Maze3DIBO;
 	Texture* Maze3DDiffuse;
 	Texture* Maze3DSpecular;
+	GridVisibility* visibility;	//the tiles seen in the last frame, for the maze, the pellets and the ghosts
+	MazeChunks* chunks;	//the walls of a streamed level, nullptr when they are all in Maze3DIBO
 public:
 
 	Shader* m_Shader;
-	std::vector<std::vector<int>> map2d;
 
 	Maze3D(ScenarioLoader* loadedLevel, Shader* shader, Renderer* renderer);
 	~Maze3D();
@@ -65,14 +65,13 @@ public:
 	inline int getHeight() { return height; }
 	inline int getWidth() { return width; }
 	inline int getPelletCount() { return pelletCount; }
-	inline std::vector<std::vector<int>> Maze3D::getMap() { return map2d; }
-	glm::vec3 findSpawn();
+	inline const GridVisibility* getVisibility() const { return visibility; }
+	inline int getDrawnTriangles() const { return drawnTriangles; }	//of the maze in the last frame, after culling
+	inline MazeGrid getMap() const { return m_Grid; }
+	inline int getTile(int y, int x) const { return m_Grid(y, x); }
 	void Light(const float dt, Camera camera);
 	void Transform(float dt);
 private:
 	void countPellets();
-	void make2dArray();
-	void makeIndices();
-	void makeVertices();
 	void generateMaze3D();
 };
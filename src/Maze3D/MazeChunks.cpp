@@ -0,0 +1,254 @@
+/**
+ * @file MazeChunks.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Source code for the MazeChunks class
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "MazeChunks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+	const int UPLOADS_PER_FRAME = 2;	//chunks uploaded per frame at most, a 32x32 chunk is at most a few hundred KB
+}
+
+/**
+ * @brief Construct a new MazeChunks::MazeChunks object, starting the background thread.
+ *
+ * @param grid 		- The tiles of the level
+ * @param chunkSize - The width and height of a chunk in tiles
+ * @param radius 	- How many chunks around the one of the camera are loaded in every direction
+ */
+MazeChunks::MazeChunks(MazeGrid grid, int chunkSize, int radius)
+	:	m_Grid(grid),
+		width(grid.getWidth()),
+		height(grid.getHeight()),
+		chunkSize(chunkSize),
+		radius(radius),
+		chunksX((width + chunkSize - 1) / chunkSize),
+		chunksZ((height + chunkSize - 1) / chunkSize),
+		centerX(-1),
+		centerZ(-1),
+		stopping(false)
+{
+	worker = std::thread(&MazeChunks::work, this);
+}
+
+/**
+ * @brief Destroy the MazeChunks::MazeChunks object, stopping the background thread and freeing the buffers.
+ *
+ */
+MazeChunks::~MazeChunks()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	worker.join();
+
+	for (auto mesh : finished)
+		delete mesh;
+	for (auto mesh : uploads)
+		delete mesh;
+	for (auto& slot : slots) {
+		delete slot.vao;
+		delete slot.vbo;
+		delete slot.ibo;
+	}
+}
+
+/**
+ * @brief 	Moves the loaded area with the camera: evicts the chunks left behind, requests
+ * 			the ones coming into range and uploads what the background thread has meshed.
+ * 			Called once per frame on the thread owning the OpenGL context.
+ *
+ * @param position - The position of the camera
+ */
+void MazeChunks::update(const glm::vec3& position)
+{
+	int cameraX = std::max(0, std::min(chunksX - 1, (int)std::floor(position.x / chunkSize)));
+	int cameraZ = std::max(0, std::min(chunksZ - 1, (int)std::floor(position.z / chunkSize)));
+	if (cameraX != centerX || cameraZ != centerZ) {
+		centerX = cameraX;
+		centerZ = cameraZ;
+
+		//One chunk past the radius is kept, walking back and forth over a border does not reload anything
+		for (auto entry = resident.begin(); entry != resident.end();) {
+			if (distance(entry->first) > radius + 1) {
+				if (entry->second != -1)
+					freeSlots.push_back(entry->second);
+				entry = resident.erase(entry);
+			}
+			else
+				entry++;
+		}
+		request(cameraX, cameraZ);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		uploads.insert(uploads.end(), finished.begin(), finished.end());
+		finished.clear();
+	}
+
+	int uploaded = 0;
+	while (uploaded < UPLOADS_PER_FRAME && !uploads.empty()) {
+		ChunkMesh* mesh = uploads.front();
+		uploads.pop_front();
+		pending.erase(mesh->chunk);
+		if (distance(mesh->chunk) <= radius + 1) {
+			if (!mesh->indices.empty())
+				uploaded++;
+			upload(mesh);
+		}
+		delete mesh;
+	}
+}
+
+/**
+ * @brief Draws the resident chunks inside the frustum with any tile visible.
+ *
+ * @param renderer 	- The Maze3D's renderer
+ * @param shader 	- The Maze3D's shader, with its uniforms and textures already set
+ * @param frustum 	- The view frustum of the camera
+ * @param visibility - The tiles the camera sees
+ * @return int 		- How many triangles were drawn
+ */
+int MazeChunks::draw(Renderer* renderer, Shader* shader, const Frustum& frustum, const GridVisibility& visibility) const
+{
+	int triangles = 0;
+	for (const auto& entry : resident) {
+		if (entry.second == -1)
+			continue;
+		int x = (entry.first % chunksX) * chunkSize, z = (entry.first / chunksX) * chunkSize;
+		glm::vec3 min(x, 0, z), max(std::min(x + chunkSize, width), 1, std::min(z + chunkSize, height));
+		if (frustum.intersects(min, max) && visibility.isAreaVisible(x, z, (int)max.x, (int)max.z)) {
+			renderer->Draw(slots[entry.second].vao, slots[entry.second].ibo, shader);
+			triangles += slots[entry.second].ibo->getCount() / 3;
+		}
+	}
+	return triangles;
+}
+
+/**
+ * @brief 	Queues the chunks within the radius that are neither resident nor queued, and
+ * 			sorts the queue so the ones closest to the camera are meshed first. Queued
+ * 			chunks the camera has moved away from are dropped before they are meshed.
+ *
+ * @param cameraX - The x coordinate of the camera's chunk
+ * @param cameraZ - The z coordinate of the camera's chunk
+ */
+void MazeChunks::request(int cameraX, int cameraZ)
+{
+	std::vector<int> wanted;
+	for (int z = std::max(0, cameraZ - radius); z <= std::min(chunksZ - 1, cameraZ + radius); z++)
+		for (int x = std::max(0, cameraX - radius); x <= std::min(chunksX - 1, cameraX + radius); x++) {
+			int chunk = z * chunksX + x;
+			if (resident.count(chunk) == 0 && pending.count(chunk) == 0) {
+				wanted.push_back(chunk);
+				pending.insert(chunk);
+			}
+		}
+
+	auto closer = [this, cameraX, cameraZ](int a, int b) {
+		int ax = a % chunksX - cameraX, az = a / chunksX - cameraZ;
+		int bx = b % chunksX - cameraX, bz = b / chunksX - cameraZ;
+		return ax * ax + az * az < bx * bx + bz * bz;
+	};
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (auto chunk = requests.begin(); chunk != requests.end();) {
+			if (distance(*chunk) > radius + 1) {
+				pending.erase(*chunk);
+				chunk = requests.erase(chunk);
+			}
+			else
+				chunk++;
+		}
+		requests.insert(requests.end(), wanted.begin(), wanted.end());
+		std::sort(requests.begin(), requests.end(), closer);
+	}
+	wake.notify_one();
+}
+
+/**
+ * @brief 	Uploads a meshed chunk into a free slot, or a new one if none is free. The buffers
+ * 			of a slot are resized to the chunk, nothing else is allocated on the gpu.
+ *
+ * @param mesh - The chunk
+ */
+void MazeChunks::upload(ChunkMesh* mesh)
+{
+	if (mesh->indices.empty()) {
+		resident[mesh->chunk] = -1;
+		return;
+	}
+
+	int slot;
+	if (!freeSlots.empty()) {
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+	}
+	else {
+		Slot created;
+		created.vao = new VertexArray;
+		created.vbo = new VertexBuffer(nullptr, 0);
+		VertexBufferLayout layout;
+		layout.PushInteger<unsigned short>(4);
+		created.vao->AddBuffer(*created.vbo, layout);
+		created.ibo = new IndexBuffer(nullptr, 0);
+		slots.push_back(created);
+		slot = (int)slots.size() - 1;
+	}
+
+	slots[slot].vao->Bind();
+	slots[slot].vbo->updateBuffer(mesh->vertices.data(), (unsigned int)(mesh->vertices.size() * sizeof(Vertex)));
+	slots[slot].ibo->selectIndices(mesh->indices.data(), (unsigned int)mesh->indices.size());
+	slots[slot].vao->Unbind();
+	resident[mesh->chunk] = slot;
+}
+
+/**
+ * @brief The background thread: meshes the requested chunks one at a time until the chunks are destroyed.
+ *
+ */
+void MazeChunks::work()
+{
+	while (true) {
+		int chunk;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wake.wait(lock, [this] { return stopping || !requests.empty(); });
+			if (stopping)
+				return;
+			chunk = requests.front();
+			requests.pop_front();
+		}
+
+		//The tiles of a compiled level are mapped, the pages of the chunk are read from the disk here and not while drawing
+		ChunkMesh* mesh = new ChunkMesh;
+		mesh->chunk = chunk;
+		makeMazeChunk(m_Grid, (chunk % chunksX) * chunkSize, (chunk / chunksX) * chunkSize, chunkSize,
+					  mesh->vertices, mesh->indices);
+
+		std::lock_guard<std::mutex> lock(mutex);
+		finished.push_back(mesh);
+	}
+}
+
+/**
+ * @brief How many chunks a chunk is from the camera's, in the direction it is the furthest.
+ *
+ */
+int MazeChunks::distance(int chunk) const
+{
+	return std::max(std::abs(chunk % chunksX - centerX), std::abs(chunk / chunksX - centerZ));
+}
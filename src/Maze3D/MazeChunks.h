@@ -0,0 +1,96 @@
+/**
+ * @file MazeChunks.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the MazeChunks class
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "../Core/VertexArray.h"
+#include "../Core/VertexBuffer.h"
+#include "../Core/VertexBufferLayout.h"
+#include "../Core/IndexBuffer.h"
+#include "../Core/Renderer.h"
+#include "../Core/LevelGeometry.h"
+#include "../Core/Frustum.h"
+#include "../Core/GridVisibility.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * @class MazeChunks
+ * @brief 	The walls of a level too large to keep on the gpu as a whole (see isStreamedLevel()),
+ * 			split into square chunks. The chunks around the camera are meshed on a background
+ * 			thread, nearest first, and uploaded a few per frame; the ones left behind are
+ * 			evicted and their buffers reused. At most (2 * (radius + 1) + 1)^2 chunks are ever
+ * 			resident, however large the level is.
+ */
+class MazeChunks
+{
+public:
+	MazeChunks(MazeGrid grid, int chunkSize = 32, int radius = 4);
+	~MazeChunks();
+
+	MazeChunks(const MazeChunks&) = delete;
+	MazeChunks& operator=(const MazeChunks&) = delete;
+
+	void update(const glm::vec3& position);
+	int draw(Renderer* renderer, Shader* shader, const Frustum& frustum, const GridVisibility& visibility) const;
+
+	inline int getResidentCount() const { return (int)resident.size(); }
+	inline int getPendingCount() const { return (int)pending.size(); }
+
+private:
+	/**
+	 * @brief A chunk meshed by the background thread, waiting to be uploaded.
+	 */
+	struct ChunkMesh {
+		int chunk;
+		std::vector<Vertex> vertices;
+		std::vector<unsigned int> indices;
+	};
+
+	/**
+	 * @brief Buffers on the gpu holding one chunk, reused once the chunk is evicted.
+	 */
+	struct Slot {
+		VertexArray* vao;
+		VertexBuffer* vbo;
+		IndexBuffer* ibo;
+	};
+
+	MazeGrid m_Grid;
+	int width, height;
+	int chunkSize, radius;
+	int chunksX, chunksZ;
+	int centerX, centerZ;	//the chunk of the camera at the last update, -1 before the first
+
+	std::vector<Slot> slots;
+	std::vector<int> freeSlots;
+	std::unordered_map<int, int> resident;	//chunk -> slot, -1 for a chunk without walls
+	std::unordered_set<int> pending;		//requested from the background thread, not uploaded yet
+	std::deque<ChunkMesh*> uploads;			//meshed, waiting for a frame with room to upload
+
+	//Shared with the background thread
+	std::thread worker;
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::deque<int> requests;
+	std::vector<ChunkMesh*> finished;
+	bool stopping;
+
+	void work();
+	void request(int cameraX, int cameraZ);
+	void upload(ChunkMesh* mesh);
+	int distance(int chunk) const;
+};
@@ -9,50 +9,57 @@
  * 
  */
 #include "Pellet3D.h"
+#include "../Core/LevelGeometry.h"
 
 /**
  * @brief Construct a new Pellet3D::Pellet3D object
  * 
- * @param pellet 
- * @param maze 
+ * @param pellet    - The model of the pellet
+ * @param sim       - The game simulation owning the pellets
  */
-Pellet3D::Pellet3D(Model* pellet, Maze3D* maze)
-    : allEaten(false)
+Pellet3D::Pellet3D(Model* pellet, const GameSim* sim)
+    : pelletCount(0),
+    m_Sim(sim),
+    capacity(0)
 {
 	this->pellet = pellet;
-    pelletCount = maze->getPelletCount();
-    generateModelMatrices(maze);
-    addModelMatrices();
+    //Streamed levels make the matrices of the drawn pellets every frame instead of keeping one per pellet
+    if (!isStreamedLevel(m_Sim->getWidth(), m_Sim->getHeight()))
+        generateModelMatrices();
+    addInstanceBuffer();
 }
 
 /**
- * @brief generates the matrices to be used when instance drawing the pellets
- * 
- * @param maze - The maze in which the pellets are drawn
+ * @brief generates the matrix of every pellet, in the order of the simulation's pellets
  */
-void Pellet3D::generateModelMatrices(Maze3D* maze)
+void Pellet3D::generateModelMatrices()
 {
-    for (int y = 0; y < maze->map2d.size(); y++)
-        for (int x = 0; x < maze->map2d[y].size(); x++)
-            if (maze->map2d[y][x] != 1) {
-                glm::mat4 translation = glm::translate(glm::mat4(1), glm::vec3(x + .5f, 0, y + .5f));
-                glm::mat4 rotation = glm::rotate(glm::mat4(1), glm::radians(1 * 25.f), glm::vec3(0, 1, 0));
-                glm::mat4 scale = glm::scale(glm::mat4(1), glm::vec3(0.1f));
+    modelMatrices.clear();
+    modelMatrices.reserve(m_Sim->getPelletCount());
+    for (const auto& p : m_Sim->getPellets())
+        modelMatrices.push_back(makePelletMatrix(p.x, p.y));
+}
 
-                glm::mat4 transformation = translation * rotation * scale;
-                modelMatrices.push_back(transformation);
-            }
+/**
+ * @brief Returns the matrix of a pellet, made again if they are not kept
+ *
+ * @param i             - Index into the simulation's pellets
+ * @return glm::mat4    - The model matrix of the pellet
+ */
+glm::mat4 Pellet3D::matrixOf(int i) const
+{
+    if (modelMatrices.empty())
+        return makePelletMatrix(m_Sim->getPellets()[i].x, m_Sim->getPellets()[i].y);
+    return modelMatrices[i];
 }
 
 /**
- * @brief Adds the model matrices to the pellet VBO and adds it to the VAO
- * 
+ * @brief Adds the buffer of the model matrices of the drawn pellets to the pellet VAO
  */
-void Pellet3D::addModelMatrices()
+void Pellet3D::addInstanceBuffer()
 {
     glGenBuffers(1, &VBO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, pelletCount * sizeof(glm::mat4), &modelMatrices[0], GL_STATIC_DRAW);
 
     for (unsigned int i = 0; i < pellet->meshes.size(); i++)
     {
@@ -78,39 +85,43 @@ void Pellet3D::addModelMatrices()
 }
 
 /**
- * @brief Removes a pellet from the game. 
- * 
- * @param camera    - The player controlled camera
- * @param maze      - The maze in which the game occours. 
+ * @brief Uploads the matrices of the pellets that are neither eaten nor hidden.
+ *        Only the tiles the camera sees are looked at, not every pellet of the level.
+ *
+ * @param visibility    - The tiles the camera sees, nullptr to draw every pellet left
  */
-void Pellet3D::eatPellet(Camera* camera, Maze3D* maze)
+void Pellet3D::updatePellets(const GridVisibility* visibility)
 {
-    float posX = floor(camera->Position.x);
-    float posY = floor(camera->Position.z);
-    //std::cout << posY << ' ' << posX << std::endl;
-    int height = maze->getHeight(); int width = maze->getWidth();
-    int pelletIndex = 0; bool pelletEaten = false;
-    for (int y = 0; y < height; y++)
-        for (int x = 0; x < width; x++)
-            if (maze->map2d[y][x] != 1 && maze->map2d[y][x] != 9) {
-                pelletIndex++;
-                if (posX == x && posY == y)
-                    if (!pelletEaten)
-                    {
-                        pelletCount--;
-                        if (pelletCount > 0)
-                        {
-                            modelMatrices.erase(modelMatrices.begin() + --pelletIndex);
-                            glBindVertexArray(VAO);
-                            glBindBuffer(GL_ARRAY_BUFFER, VBO);
-                            glBufferData(GL_ARRAY_BUFFER, pelletCount * sizeof(glm::mat4), &modelMatrices[0], GL_STATIC_DRAW);
-                            pelletEaten = true;
-                            maze->map2d[posY][posX] = 9;
-                        } else
-                            allEaten = true;
-                    }
-            }
+    const auto& pellets = m_Sim->getPellets();
+    visibleMatrices.clear();
+    if (visibility == nullptr)
+    {
+        for (size_t i = 0; i < pellets.size(); i++)
+            if (!pellets[i].eaten)
+                visibleMatrices.push_back(matrixOf(i));
+    }
+    else
+    {
+        for (const auto& tile : visibility->getVisibleTiles())
+        {
+            int i = m_Sim->getPelletAt(tile.y, tile.x);
+            if (i != -1 && !pellets[i].eaten)
+                visibleMatrices.push_back(matrixOf(i));
+        }
+    }
 
+    pelletCount = (int)visibleMatrices.size();
+    if (pelletCount > 0)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, VBO);
+        if ((unsigned int)pelletCount > capacity)
+        {
+            capacity = pelletCount;
+            glBufferData(GL_ARRAY_BUFFER, capacity * sizeof(glm::mat4), visibleMatrices.data(), GL_STREAM_DRAW);
+        }
+        else
+            glBufferSubData(GL_ARRAY_BUFFER, 0, pelletCount * sizeof(glm::mat4), visibleMatrices.data());
+    }
 }
 
 /**
@@ -119,9 +130,11 @@ void Pellet3D::eatPellet(Camera* camera, Maze3D* maze)
  * @param shader        - The pellets shader
  * @param projection    - The players projection matrix
  * @param view          - The players view matrix
+ * @param visibility    - The tiles the camera sees, the pellets on the others are skipped
  */
-void Pellet3D::Draw(Shader* shader,glm::mat4 projection, glm::mat4 view)
+void Pellet3D::Draw(Shader* shader,glm::mat4 projection, glm::mat4 view, const GridVisibility* visibility)
 {
+    updatePellets(visibility);
     if (pelletCount > 0)
     {
         shader->use();
@@ -133,7 +146,7 @@ void Pellet3D::Draw(Shader* shader,glm::mat4 projection, glm::mat4 view)
         for (unsigned int i = 0; i < pellet->meshes.size(); i++)
         {
             glBindVertexArray(pellet->meshes[i].VAO);
-            glDrawElementsInstanced(GL_TRIANGLES, pellet->meshes[i].indices.size(), GL_UNSIGNED_INT, 0, pelletCount);
+            glDrawElementsInstanced(GL_TRIANGLES, pellet->meshes[i].indices.size(), pellet->meshes[i].indexType, 0, pelletCount);
             glBindVertexArray(0);
         }
     }
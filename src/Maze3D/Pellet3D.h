@@ -11,6 +11,7 @@
 #pragma once
 #include <GL/glew.h>
 #include "Ghost3D.h"
+#include "../Core/GridVisibility.h"
 
 /**
  * @class Pellet3D
@@ -19,17 +20,20 @@
 class Pellet3D
 {
 public:
-	Pellet3D(Model* pellet, Maze3D* maze);
+	Pellet3D(Model* pellet, const GameSim* sim);
 
-	void Draw(Shader* shader, glm::mat4 projection, glm::mat4 view);
-	void eatPellet(Camera* camera, Maze3D* maze);
-	bool allEaten;
-	int pelletCount;
+	void Draw(Shader* shader, glm::mat4 projection, glm::mat4 view, const GridVisibility* visibility = nullptr);
+	int pelletCount;	//drawn in the last frame
 private:
 	Model* pellet;
+	const GameSim* m_Sim;
 	unsigned int VAO, VBO;
-	std::vector <glm::mat4> modelMatrices;
+	unsigned int capacity;	//matrices the VBO has room for
+	std::vector <glm::mat4> modelMatrices;	//one per pellet of the simulation, empty on streamed levels
+	std::vector <glm::mat4> visibleMatrices;
 
-	void generateModelMatrices(Maze3D* maze);
-	void addModelMatrices();
+	void generateModelMatrices();
+	glm::mat4 matrixOf(int i) const;
+	void addInstanceBuffer();
+	void updatePellets(const GridVisibility* visibility);
 };
\ No newline at end of file
@@ -0,0 +1,150 @@
+/**
+ * @file AIScheduler.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Class for spending a fixed amount of time on pathfinding every frame.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "AIScheduler.h"
+
+#include <chrono>
+
+namespace {
+	//A tick of waiting outweighs this many tiles of distance to the player
+	const int STALENESS_WEIGHT = 8;
+}
+
+/**
+ * @brief Construct a new AIScheduler::AIScheduler object
+ *
+ * @param budgetMicroseconds - Time spent on the requests every frame, 0 to serve them all right away
+ */
+AIScheduler::AIScheduler(int budgetMicroseconds)
+	:	budget(budgetMicroseconds),
+		served(0),
+		spent(0),
+		longestWait(0)
+{
+}
+
+/**
+ * @brief Starts a new frame, giving the scheduler its whole budget again.
+ *
+ */
+void AIScheduler::beginFrame()
+{
+	served = 0;
+	spent = 0;
+	longestWait = 0;
+}
+
+/**
+ * @brief 	Queues a path request. If it is already queued only the distance is updated,
+ * 			it keeps its place in line.
+ *
+ * @param id 		- Who the path is for
+ * @param tick 		- The current tick
+ * @param distance 	- Tiles between the ghost and the player
+ */
+void AIScheduler::request(int id, unsigned long long tick, int distance)
+{
+	int i = find(id);
+	if (i != -1)
+		requests[i].distance = distance;
+	else
+		requests.push_back({ id, tick, distance });
+}
+
+/**
+ * @brief Removes a request, if it is queued.
+ *
+ * @param id - Who the path was for
+ */
+void AIScheduler::cancel(int id)
+{
+	int i = find(id);
+	if (i == -1)
+		return;
+	requests[i] = requests.back();
+	requests.pop_back();
+}
+
+/**
+ * @brief Removes every request.
+ *
+ */
+void AIScheduler::clear()
+{
+	requests.clear();
+}
+
+/**
+ * @brief 	Serves requests in order of priority until they are all served or the budget
+ * 			of this frame is spent. Can be called several times a frame (once every tick),
+ * 			the budget is shared until the next beginFrame.
+ *
+ * @param tick 	- The current tick
+ * @param serve - Called with the id of every request served, does the actual pathfinding
+ * @return int 	- The amount of requests served by this call
+ */
+int AIScheduler::run(unsigned long long tick, const std::function<void(int)>& serve)
+{
+	int count = 0;
+	while (!requests.empty()) {
+		if (budget > 0 && served > 0 && spent >= budget)
+			break;
+
+		int i = highestPriority(tick);
+		PathRequest next = requests[i];
+		requests[i] = requests.back();
+		requests.pop_back();
+		if (tick - next.queuedTick > longestWait)
+			longestWait = tick - next.queuedTick;
+
+		auto begin = std::chrono::steady_clock::now();
+		serve(next.id);
+		spent += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+		served++;
+		count++;
+	}
+	return count;
+}
+
+/**
+ * @brief Finds a request.
+ *
+ * @param id 	- Who the path is for
+ * @return int 	- Index in requests, -1 if not queued
+ */
+int AIScheduler::find(int id) const
+{
+	for (size_t i = 0; i < requests.size(); i++)
+		if (requests[i].id == id)
+			return i;
+	return -1;
+}
+
+/**
+ * @brief 	Finds the request to serve next, the one with the highest ticks waited times
+ * 			STALENESS_WEIGHT minus the distance to the player. Ties go to the request
+ * 			queued first.
+ *
+ * @param tick 	- The current tick
+ * @return int 	- Index in requests
+ */
+int AIScheduler::highestPriority(unsigned long long tick) const
+{
+	int best = 0;
+	long long bestScore = 0;
+	for (size_t i = 0; i < requests.size(); i++) {
+		long long score = (long long)(tick - requests[i].queuedTick) * STALENESS_WEIGHT - requests[i].distance;
+		if (i == 0 || score > bestScore || (score == bestScore && requests[i].queuedTick < requests[best].queuedTick)) {
+			best = i;
+			bestScore = score;
+		}
+	}
+	return best;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file AIScheduler.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the AIScheduler class.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <vector>
+#include <functional>
+
+/**
+ * @brief A queued path request, id is chosen by the owner of the scheduler (e.g. the index of a ghost).
+ */
+struct PathRequest {
+	int					id;
+	unsigned long long	queuedTick;	//when it was first queued, kept if it is queued again
+	int					distance;	//tiles to the player when last queued
+};
+
+/**
+ * @class AIScheduler
+ * @brief 	Spreads the path requests of the ghosts over the frames. Every frame only a
+ * 			fixed amount of microseconds is spent on the requests, the rest wait for the
+ * 			next frame while the ghosts keep following the path they already have. The
+ * 			requests are ordered by how long they have waited, with a tick of waiting
+ * 			worth several tiles of distance to the player, so the ghosts close to the
+ * 			player go first without starving the ones far away. At least one request is
+ * 			served every frame, so a single query larger than the budget can not stall
+ * 			the queue.
+ *
+ * 			A budget of 0 serves every request right away.
+ */
+class AIScheduler
+{
+public:
+	AIScheduler(int budgetMicroseconds = 0);
+
+	void beginFrame();
+	void request(int id, unsigned long long tick, int distance);
+	void cancel(int id);
+	void clear();
+	int  run(unsigned long long tick, const std::function<void(int)>& serve);
+
+	inline void setBudget(int microseconds)		{ budget = microseconds; }
+	inline int  getBudget()				const	{ return budget; }
+	inline int  getPending()			const	{ return (int)requests.size(); }
+	inline bool isQueued(int id)		const	{ return find(id) != -1; }
+	inline int  getServedThisFrame()	const	{ return served; }
+	inline long long getSpentThisFrame() const	{ return spent; }	//microseconds
+	inline unsigned long long getLongestWait() const { return longestWait; }	//ticks, since the last beginFrame
+
+private:
+	int budget;		//microseconds per frame, 0 for no limit
+	int served;
+	long long spent;
+	unsigned long long longestWait;
+
+	std::vector<PathRequest> requests;	//only a few dozen, so they are searched linearly
+
+	int find(int id) const;
+	int highestPriority(unsigned long long tick) const;
+};
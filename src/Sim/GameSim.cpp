@@ -0,0 +1,600 @@
+/**
+ * @file GameSim.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Source code for the GameSim class
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "GameSim.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace {
+	const int HIERARCHY_MIN_CELLS = 256 * 256;	//levels this large search per ghost instead of flooding the level
+	const int HIERARCHY_BUDGET_US = 100;		//time a single ghost query may take on those levels
+	const int ROUTE_STEPS = 16;					//steps of an incremental plan kept for following
+	const int NEXT_HOP_ROW_REQUEST = -1;		//scheduler id of the shared next hop row, ghosts use their index
+	const int offsetY[4] = { -1, 1, 0, 0 };		//same order as FlowStep
+	const int offsetX[4] = { 0, 0, -1, 1 };
+}
+
+/**
+ * @brief Construct a new GameSim::GameSim object
+ *
+ * @param loadedLevel 	- A ScenarioLoader containing the level file
+ * @param ghostCount 	- How many ghosts to spawn, ghost i uses the ID 3 + i in the level
+ *
+ * @see generatePellets();
+ */
+GameSim::GameSim(ScenarioLoader* loadedLevel, int ghostCount)
+	:	width(loadedLevel->getHorizontalSize()),
+		height(loadedLevel->getVerticalSize()),
+		remainingPellets(0),
+		unreachablePellets(0),
+		constrainMovement(true),
+		playerEaten(false),
+		pelletGeneration(0),
+		tickCount(0),
+		compiled(loadedLevel->getCompiledLevel()),
+		map2d(loadedLevel->getGrid()),
+		rowGoalY(-1),
+		rowGoalX(-1),
+		pathPlanner(PathPlanner::Automatic)
+{
+	//A compiled level has the spawns, a parsed one is searched for them
+	size_t spawnCount = 0;
+	const LevelSpawn* compiledSpawns = compiled ? compiled->getSection<LevelSpawn>(LevelSection::Spawns, spawnCount) : nullptr;
+	if (compiledSpawns != nullptr)
+		spawns.assign(compiledSpawns, compiledSpawns + spawnCount);
+	else
+		placeSpawns(map2d, spawns);
+
+	player.position = findSpawn();
+	generatePellets();
+
+	//Large levels without room for the whole table only use the hierarchical graph, the
+	//table is not even made then, its arrays per tile and per cell would never be read
+	nextHop = nullptr;
+	hierarchy = nullptr;
+	if (NextHopTable::fitsInMemory(NextHopTable::countCells(map2d), NextHopTable::DEFAULT_MAX_BYTES) || width * height < HIERARCHY_MIN_CELLS) {
+		nextHop = new NextHopTable(map2d);
+		loadNextHopTable(loadedLevel->isEmbedded() ? "" : loadedLevel->getFilePath());
+	}
+	else {
+		hierarchy = new HierarchicalGraph(map2d, true, 16, HIERARCHY_BUDGET_US);
+		hierarchy->build();
+	}
+
+	player.wishMove = glm::vec3(0.f);
+	player.movementSpeed = 2.5f;
+
+	for (int i = 0; i < ghostCount; i++) {
+		SimGhost ghost;
+		ghost.id = 3 + i;
+		ghost.posX = ghost.posY = 0.f;
+		ghost.direction = West;
+		ghost.rotationAngle = 0.f;
+		ghost.movementSpeed = 1.f;
+		setSpawn(ghost);
+		ghosts.push_back(ghost);
+		routes.push_back({ -1, -1, -1, -1, {}, 0 });
+	}
+}
+
+/**
+ * @brief Destroy the GameSim::GameSim object
+ *
+ */
+GameSim::~GameSim()
+{
+	delete nextHop;
+	delete hierarchy;
+	for (auto planner : planners)
+		delete planner;
+}
+
+/**
+ * @brief 	Places the pellets, see placePellets(). A compiled level already has the list of
+ * 			pellets.
+ *
+ */
+void GameSim::generatePellets()
+{
+	size_t count = 0;
+	const LevelTile* tiles = compiled ? compiled->getSection<LevelTile>(LevelSection::Pellets, count) : nullptr;
+	std::vector<LevelTile> placed;
+	if (tiles != nullptr) {
+		unreachablePellets = (int)std::count_if(map2d.data(), map2d.data() + map2d.size(), [](uint8_t tile) { return tile != 1 && tile != EMPTY_TILE; });
+		unreachablePellets -= (int)count;
+	}
+	else {
+		unreachablePellets = placePellets(map2d, (int)player.position.z, (int)player.position.x, placed);
+		tiles = placed.data();
+		count = placed.size();
+	}
+
+	//The pellets are placed row after row, a row's pellets are found from where it starts
+	pelletRows.assign(height + 1, 0);
+	pellets.reserve(count);
+	for (size_t i = 0; i < count; i++) {
+		pelletRows[tiles[i].y + 1]++;
+		pellets.push_back({ tiles[i].x, tiles[i].y, false });
+	}
+	for (int y = 0; y < height; y++)
+		pelletRows[y + 1] += pelletRows[y];
+	remainingPellets = pellets.size();
+}
+
+/**
+ * @brief 	Finds the pellet on a tile, by a binary search of the pellets of its row. Only
+ * 			an index per row is kept, not one per tile.
+ *
+ * @param y 	- The y coordinate of the tile
+ * @param x 	- The x coordinate of the tile
+ * @return int 	- Index into getPellets(), -1 if the tile has no pellet
+ */
+int GameSim::getPelletAt(int y, int x) const
+{
+	auto first = pellets.begin() + pelletRows[y];
+	auto last = pellets.begin() + pelletRows[y + 1];
+	auto pellet = std::lower_bound(first, last, x, [](const SimPellet& p, int x) { return p.x < x; });
+	return pellet != last && pellet->x == x ? (int)(pellet - pellets.begin()) : -1;
+}
+
+/**
+ * @brief Finds the players spawning point.
+ *
+ * @return glm::vec3 - The center of the spawn tile
+ */
+glm::vec3 GameSim::findSpawn()
+{
+	int spawnY, spawnX;
+	if (findSpawnTile(2, spawnY, spawnX))
+		return glm::vec3((float)spawnX + .5f, 0.5f, (float)spawnY + .5f);
+	return glm::vec3(0.5f);
+}
+
+/**
+ * @brief 	Finds the spawn location of the ghost based on its unique ID.
+ *
+ * @param ghost - The ghost to be placed
+ */
+void GameSim::setSpawn(SimGhost& ghost)
+{
+	int spawnY, spawnX;
+	if (findSpawnTile(ghost.id, spawnY, spawnX)) {
+		ghost.posX = spawnX;
+		ghost.posY = spawnY;
+	}
+}
+
+/**
+ * @brief Looks up where an ID of the level file is placed.
+ *
+ * @param id 		- 2 for the player, 3 and up for the ghosts
+ * @param y 		- Set to the y coordinate of the tile
+ * @param x 		- Set to the x coordinate of the tile
+ * @return true 	- The level has the ID
+ */
+bool GameSim::findSpawnTile(int id, int& y, int& x) const
+{
+	for (const auto& spawn : spawns)
+		if (spawn.id == id) {
+			y = spawn.y;
+			x = spawn.x;
+			return true;
+		}
+	return false;
+}
+
+/**
+ * @brief Sets the world space movement the player wants to do during the next ticks.
+ *
+ * @param wishMove - Sum of the camera vectors for the keys currently held down
+ */
+void GameSim::setPlayerInput(glm::vec3 wishMove)
+{
+	player.wishMove = wishMove;
+}
+
+/**
+ * @brief 	Chooses the pathfinding used by the ghosts. The incremental planners are made
+ * 			the first time they are needed, and plan from scratch on their first query.
+ *
+ * @param planner - The pathfinding to use from the next tick
+ */
+void GameSim::setPathPlanner(PathPlanner planner)
+{
+	pathPlanner = planner;
+	if (planner == PathPlanner::Incremental && planners.empty())
+		for (size_t i = 0; i < ghosts.size(); i++)
+			planners.push_back(new DStarLite(map2d));
+	for (auto& route : routes) {
+		route.goalY = route.goalX = route.y = route.x = -1;
+		route.steps.clear();
+		route.next = 0;
+	}
+	scheduler.clear();
+}
+
+/**
+ * @brief 	Gives a ghost a route found outside the sim, used with PathPlanner::External.
+ * 			The ghost follows it like a route of its own.
+ *
+ * @param ghost - Index of the ghost
+ * @param y 	- The y coordinate of the tile the route starts on
+ * @param x 	- The x coordinate of the tile the route starts on
+ * @param goalY - The y coordinate of the player's tile the route leads towards
+ * @param goalX - The x coordinate of the player's tile the route leads towards
+ * @param steps - The steps of the route, it ends at the first StepNone
+ * @param count - The amount of steps
+ */
+void GameSim::setGhostRoute(int ghost, int y, int x, int goalY, int goalX, const FlowStep* steps, int count)
+{
+	GhostRoute& route = routes[ghost];
+	route.goalY = goalY;
+	route.goalX = goalX;
+	route.y = y;
+	route.x = x;
+	route.next = 0;
+	route.steps.clear();
+	for (int i = 0; i < count && steps[i] != StepNone; i++)
+		route.steps.push_back(steps[i]);
+}
+
+/**
+ * @brief 	Advances the game by one fixed step. Called any number of times per frame,
+ * 			or as fast as possible when running headless.
+ *
+ * @param dt - The fixed timestep
+ */
+void GameSim::tick(const float dt)
+{
+	if (isGameOver())
+		return;
+
+	movePlayer(dt);
+	eatPellet();
+
+	if (constrainMovement) {
+		queuePathRequests();
+		scheduler.run(tickCount, [this](int id) { servePathRequest(id); });
+		for (auto& ghost : ghosts) {
+			moveGhost(ghost, dt);
+			if (playerEaten)
+				break;
+		}
+	}
+
+	tickCount++;
+}
+
+/**
+ * @brief Moves the player according to the latest input.
+ *
+ * @param dt - The fixed timestep
+ */
+void GameSim::movePlayer(const float dt)
+{
+	glm::vec3 oldPos = player.position;
+	player.position += player.wishMove * player.movementSpeed * dt;
+
+	if (constrainMovement)
+		constrainPlayer(oldPos);
+}
+
+/**
+ * @brief Stops the player from walking through walls, and handles the tunnel.
+ *
+ * @param oldPos - The position of the player before it moved this tick
+ */
+void GameSim::constrainPlayer(glm::vec3 oldPos)
+{
+	glm::vec3& pos = player.position;
+
+	if (pos.z != oldPos.z) {
+		if (pos.z - oldPos.z < 0.0f) {
+			if (map2d((int)floor(pos.z - 0.1f), (int)floor(pos.x)) == 1)
+				pos.z = oldPos.z;
+		}
+		else if (map2d((int)floor(pos.z + 0.1f), (int)floor(pos.x)) == 1)
+			pos.z = oldPos.z;
+	}
+	if (pos.x != oldPos.x) {
+		if (pos.x - oldPos.x < 0.0f) {
+			if (map2d((int)floor(pos.z), (int)floor(pos.x - 0.1f)) == 1)
+				pos.x = oldPos.x;
+		}
+		else if (map2d((int)floor(pos.z), (int)floor(pos.x + 0.1f)) == 1)
+			pos.x = oldPos.x;
+	}
+	pos.y = 0.5f;
+
+	//"Teleport" the player if they use the "tunnel"
+	if (pos.x <= 0.3f)
+		pos.x = width - 1.f;
+	if (pos.x >= width - 0.3f)
+		pos.x = 1.f;
+}
+
+/**
+ * @brief Removes the pellet on the tile the player is standing on, if any.
+ *
+ */
+void GameSim::eatPellet()
+{
+	int x = floor(player.position.x);
+	int y = floor(player.position.z);
+	if (y < 0 || y >= height || x < 0 || x >= width)
+		return;
+
+	int i = getPelletAt(y, x);
+	if (i != -1 && !pellets[i].eaten) {
+		pellets[i].eaten = true;
+		remainingPellets--;
+		pelletGeneration++;
+	}
+}
+
+/**
+ * @brief 	Uses the next hop table of the compiled level, or loads the one saved next to
+ * 			the level file, or builds and saves it if there is none (or it belongs to an
+ * 			older version of the level).
+ * 			Levels too large for the table compute the rows towards the player on demand.
+ *
+ * @param levelPath - The path to the level file, empty for a level embedded into the executable
+ * 					  (the table is then built every time, nothing is read or written)
+ */
+void GameSim::loadNextHopTable(const std::string& levelPath)
+{
+	size_t compiledBytes = 0;
+	const unsigned char* compiledTable = compiled ? compiled->getSection<unsigned char>(LevelSection::NextHopTable, compiledBytes) : nullptr;
+	if (!nextHop->fitsInMemory() || nextHop->borrow(compiledTable, compiledBytes))
+		return;
+
+	if (levelPath.empty()) {
+		nextHop->build();
+		return;
+	}
+
+	std::string tablePath = levelPath + ".nexthop";
+	if (!nextHop->load(tablePath)) {
+		nextHop->build();
+		nextHop->save(tablePath);
+	}
+}
+
+/**
+ * @brief Checks wheter the ghosts follow paths of their own, instead of the shared next hop table.
+ *
+ * @return true - The incremental planners, external routes or the hierarchical graph are used
+ */
+bool GameSim::usesGhostRoutes() const
+{
+	if (pathPlanner != PathPlanner::Automatic)
+		return true;
+	return hierarchy != nullptr;
+}
+
+/**
+ * @brief Manhattan distance between two tiles, taking the tunnel into account.
+ *
+ * @return int - The distance in tiles
+ */
+int GameSim::tileDistance(int y, int x, int goalY, int goalX) const
+{
+	int dx = abs(x - goalX);
+	return abs(y - goalY) + std::min(dx, width - dx);
+}
+
+/**
+ * @brief 	Moves a route forward over the tiles the ghost has entered since it was last
+ * 			checked.
+ *
+ * @param route - The route of the ghost
+ * @param y 	- The y coordinate of the ghost's tile
+ * @param x 	- The x coordinate of the ghost's tile
+ * @return true - The ghost is on the route and there are steps left
+ */
+bool GameSim::advanceRoute(GhostRoute& route, int y, int x) const
+{
+	while (route.next < route.steps.size() && (route.y != y || route.x != x)) {
+		FlowStep step = route.steps[route.next];
+		int nextY = route.y + offsetY[step];
+		int nextX = (route.x + offsetX[step] + width) % width;
+		if (nextY != y || nextX != x)
+			return false;
+		route.y = nextY;
+		route.x = nextX;
+		route.next++;
+	}
+	return route.next < route.steps.size() && route.y == y && route.x == x;
+}
+
+/**
+ * @brief 	Queues the paths that need to be found again: the next hop row towards the
+ * 			player once the player has changed tile (when the table is not precomputed), or every ghost that has left or finished its route or whose
+ * 			route leads to where the player was. Requests already queued keep their place.
+ *
+ */
+void GameSim::queuePathRequests()
+{
+	int goalY = floor(player.position.z);
+	int goalX = floor(player.position.x);
+	if (goalY < 0 || goalY >= height || goalX < 0 || goalX >= width || pathPlanner == PathPlanner::External)
+		return;
+
+	if (!usesGhostRoutes()) {
+		if (!nextHop->isPrecomputed() && (goalY != rowGoalY || goalX != rowGoalX))
+			scheduler.request(NEXT_HOP_ROW_REQUEST, tickCount, 0);
+		return;
+	}
+
+	for (size_t i = 0; i < ghosts.size(); i++) {
+		int y = floor(ghosts[i].posY);
+		int x = floor(ghosts[i].posX);
+		if (y < 0 || y >= height || x < 0 || x >= width || (y == goalY && x == goalX))
+			continue;
+		GhostRoute& route = routes[i];
+		if (!advanceRoute(route, y, x) || route.goalY != goalY || route.goalX != goalX)
+			scheduler.request(i, tickCount, tileDistance(y, x, goalY, goalX));
+	}
+}
+
+/**
+ * @brief 	Does the pathfinding of a request, called by the scheduler. Everything is
+ * 			looked up again, as the request might have waited a few ticks.
+ *
+ * @param id - Index of the ghost, or NEXT_HOP_ROW_REQUEST
+ */
+void GameSim::servePathRequest(int id)
+{
+	int goalY = floor(player.position.z);
+	int goalX = floor(player.position.x);
+	if (goalY < 0 || goalY >= height || goalX < 0 || goalX >= width)
+		return;
+
+	if (id == NEXT_HOP_ROW_REQUEST) {
+		if (nextHop->loadRow(goalY, goalX)) {	//a lookup in the cache when the player has been here lately
+			rowGoalY = goalY;
+			rowGoalX = goalX;
+		}
+		return;
+	}
+
+	int y = floor(ghosts[id].posY);
+	int x = floor(ghosts[id].posX);
+	if (y < 0 || y >= height || x < 0 || x >= width)
+		return;
+	planRoute(id, y, x, goalY, goalX);
+}
+
+/**
+ * @brief 	Plans a new route for a ghost, with its incremental planner if chosen and with
+ * 			the hierarchical graph otherwise. The incremental planner is told where the
+ * 			ghost and the player moved and only repairs its search, the route is the first
+ * 			ROUTE_STEPS steps of it. The hierarchical graph gives the steps to the first
+ * 			entrance along its path.
+ *
+ * @param ghostIndex 	- Index of the ghost in ghosts
+ * @param y 			- The y coordinate of the ghost's tile
+ * @param x 			- The x coordinate of the ghost's tile
+ * @param goalY 		- The y coordinate of the player's tile
+ * @param goalX 		- The x coordinate of the player's tile
+ */
+void GameSim::planRoute(int ghostIndex, int y, int x, int goalY, int goalX)
+{
+	GhostRoute& route = routes[ghostIndex];
+	route.goalY = goalY;
+	route.goalX = goalX;
+	route.y = y;
+	route.x = x;
+	route.next = 0;
+	route.steps.clear();
+	if (y == goalY && x == goalX)
+		return;
+
+	FlowStep step;
+	if (pathPlanner == PathPlanner::Incremental) {
+		DStarLite* planner = planners[ghostIndex];
+		if (!planner->isInitialised())
+			planner->reset(y, x, goalY, goalX);
+		else {
+			planner->moveStart(y, x);
+			planner->moveGoal(goalY, goalX);
+		}
+		if (planner->NextStep(step))
+			planner->GetPath(route.steps, ROUTE_STEPS);
+	}
+	else
+		hierarchy->FindPath(y, x, goalY, goalX, step, &route.steps);
+}
+
+/**
+ * @brief 	Move the ghost one step towards the player, along its own route if it has one.
+ * 			Otherwise the next hop table is used, when it is not precomputed the ghosts
+ * 			follow the row towards where the player was when it was last loaded. A ghost
+ * 			waiting for a new route keeps going the way it was going while it can.
+ *
+ * @param ghost - The ghost to be moved
+ * @param dt 	- The fixed timestep
+ */
+void GameSim::moveGhost(SimGhost& ghost, const float dt)
+{
+	int y = floor(ghost.posY);
+	int x = floor(ghost.posX);
+	if (y < 0 || y >= height || x < 0 || x >= width)
+		return;
+
+	int goalY = floor(player.position.z);
+	int goalX = floor(player.position.x);
+	if (y == goalY && x == goalX) {
+		playerEaten = true;
+		return;
+	}
+
+	FlowStep step = StepNone;
+	if (usesGhostRoutes()) {
+		GhostRoute& route = routes[&ghost - &ghosts[0]];
+		if (advanceRoute(route, y, x))
+			step = route.steps[route.next];
+		else if (route.goalY != -1 && canStep(y, x, (FlowStep)ghost.direction))
+			step = (FlowStep)ghost.direction;
+	}
+	else if (nextHop->isPrecomputed())
+		nextHop->NextStep(y, x, goalY, goalX, step);
+	else
+		nextHop->NextStep(y, x, rowGoalY, rowGoalX, step);
+	if (step == StepNone)	//the player can not be reached from here
+		return;
+
+	ghost.direction = (Direction)step;
+	translateGhost(ghost, ghost.direction, dt);
+}
+
+/**
+ * @brief Checks wheter the tile next to a tile in a direction can be walked on.
+ *
+ * @param y 	- The y coordinate of the tile
+ * @param x 	- The x coordinate of the tile
+ * @param step 	- The direction
+ * @return true - The tile is inside the map and not a wall
+ */
+bool GameSim::canStep(int y, int x, FlowStep step) const
+{
+	int nextY = y + offsetY[step];
+	int nextX = (x + offsetX[step] + width) % width;
+	return nextY >= 0 && nextY < height && map2d(nextY, nextX) != 1;
+}
+
+/**
+ * @brief 	Translates (moves) the ghost according to the designated direction
+ * 			the pathfinder has deemed fit.
+ *
+ * @param ghost - The ghost to be moved
+ * @param dir 	- The direction to be moved in
+ * @param dt  	- The fixed timestep
+ */
+void GameSim::translateGhost(SimGhost& ghost, Direction dir, const float dt)
+{
+	float velocity = ghost.movementSpeed * dt;
+	switch (dir)
+	{
+	case South: ghost.posY += velocity; ghost.posX = floor(ghost.posX); ghost.rotationAngle = 0.f;	 break;
+	case West:  ghost.posX += velocity; ghost.posY = floor(ghost.posY); ghost.rotationAngle = 90.f;  break;
+	case North: ghost.posY -= velocity; ghost.posX = floor(ghost.posX); ghost.rotationAngle = 180.f; break;
+	case East:  ghost.posX -= velocity; ghost.posY = floor(ghost.posY); ghost.rotationAngle = 270.f; break;
+	default:    break;
+	}
+
+	//"Teleport" the ghost if it uses the tunnel
+	if (ghost.posX < 0.f)
+		ghost.posX += width;
+	if (ghost.posX >= width)
+		ghost.posX -= width;
+}
@@ -0,0 +1,184 @@
+/**
+ * @file GameSim.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Header file for the GameSim class
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "../Core/ScenarioLoader.h"
+#include "../Core/CompiledLevel.h"
+#include "../Core/FlowField.h"
+#include "../Core/GridBitboard.h"
+#include "../Core/NextHopTable.h"
+#include "../Core/HierarchicalGraph.h"
+#include "../Core/DStarLite.h"
+#include "AIScheduler.h"
+#include "LevelPlacement.h"
+
+#include <vector>
+#include <glm/glm.hpp>
+
+/**
+ * @brief 	Enum for specifying what direction (to be moved in) / (are moving in)
+ * 			The values match the FlowStep values of the FlowField.
+ */
+enum Direction {
+	North = 0,
+	South = 1,
+	East  = 2,
+	West  = 3
+};
+
+/**
+ * @brief 	Which pathfinding the ghosts use. Automatic picks by level size (precomputed next
+ * 			hop table, rows of it computed on demand or hierarchical graph), Incremental gives every ghost its own D* Lite
+ * 			planner that is repaired as the ghost and the player move. External does no
+ * 			pathfinding at all, the routes are given with setGhostRoute (e.g. from the
+ * 			distance field computed on the gpu).
+ */
+enum class PathPlanner {
+	Automatic,
+	Incremental,
+	External
+};
+
+/**
+ * @brief Plain data describing the player (pacman).
+ *
+ */
+struct SimPlayer {
+	glm::vec3	position;
+	glm::vec3	wishMove;		//world space movement requested by the input this tick
+	float		movementSpeed;
+};
+
+/**
+ * @brief Plain data describing a single ghost.
+ *
+ */
+struct SimGhost {
+	int			id;				//the ghost's unique ID in the level file
+	float		posX,
+				posY;
+	Direction	direction;
+	float		rotationAngle;
+	float		movementSpeed;
+};
+
+/**
+ * @brief Plain data describing a single pellet.
+ *
+ */
+struct SimPellet {
+	int		x,
+			y;
+	bool	eaten;
+};
+
+/**
+ * @class GameSim
+ * @brief 	The game logic of pacman, without any OpenGL dependencies. Owns the grid,
+ * 			the player, the ghosts and the pellets, and advances them in fixed steps.
+ * 			Everything that draws the game only reads from this class.
+ */
+class GameSim
+{
+public:
+	GameSim(ScenarioLoader* loadedLevel, int ghostCount = 3);
+	~GameSim();
+
+	void tick(const float dt);
+	void setPlayerInput(glm::vec3 wishMove);
+	void setConstrainMovement(bool constrain) { constrainMovement = constrain; }
+	void setPathPlanner(PathPlanner planner);
+	void setGhostRoute(int ghost, int y, int x, int goalY, int goalX, const FlowStep* steps, int count);
+	void setPathBudget(int microseconds) { scheduler.setBudget(microseconds); }
+	void beginFrame() { scheduler.beginFrame(); }
+
+	inline const SimPlayer&					getPlayer()		const { return player; }
+	inline const std::vector<SimGhost>&		getGhosts()		const { return ghosts; }
+	inline const std::vector<SimPellet>&	getPellets()	const { return pellets; }
+	inline MazeGrid getMap()	const { return map2d; }
+
+	inline int  getWidth()				const { return width; }
+	inline int  getHeight()				const { return height; }
+	inline int  getPelletCount()		const { return (int)pellets.size(); }
+	inline int  getRemainingPellets()	const { return remainingPellets; }
+	inline int  getUnreachablePellets()	const { return unreachablePellets; }	//open tiles left without a pellet
+	int getPelletAt(int y, int x) const;	//index into getPellets(), -1 if none
+	inline unsigned int getPelletGeneration() const { return pelletGeneration; }
+	inline unsigned long long getTickCount()  const { return tickCount; }
+
+	inline PathPlanner getPathPlanner() const { return pathPlanner; }
+	inline const DStarLite* getIncrementalPlanner(int ghost) const { return planners.empty() ? nullptr : planners[ghost]; }
+	inline const AIScheduler& getScheduler() const { return scheduler; }
+	inline const NextHopTable* getNextHopTable() const { return nextHop; }	//nullptr when the hierarchical graph is used
+	inline const CompiledLevel* getCompiledLevel() const { return compiled; }	//nullptr if the level was parsed
+
+	inline bool isPlayerEaten()		const { return playerEaten; }
+	inline bool allPelletsEaten()	const { return remainingPellets == 0; }
+	inline bool isGameOver()		const { return playerEaten || allPelletsEaten(); }
+
+private:
+	int width,
+		height,
+		remainingPellets,
+		unreachablePellets;
+
+	bool constrainMovement,
+		 playerEaten;
+
+	unsigned int		pelletGeneration;	//incremented every time a pellet is eaten
+	unsigned long long	tickCount;
+	const CompiledLevel* compiled;	//the level compiled by levelc, spawns, pellets and next hop table are taken from it
+
+	MazeGrid						map2d;	//the tiles of the ScenarioLoader, which outlives the sim
+	std::vector<LevelSpawn>			spawns;	//the player and every ghost ID in the level
+	std::vector<SimPellet>			pellets;
+	std::vector<int>				pelletRows;		//index of the first pellet of every row, and the count at the end
+	std::vector<SimGhost>			ghosts;
+	SimPlayer						player;
+
+	NextHopTable* nextHop;	//next step between every pair of tiles, rows are computed on demand when not precomputed, nullptr with the hierarchy
+	int rowGoalY, rowGoalX;	//the player's tile when the row the ghosts follow was loaded, -1 before the first
+	HierarchicalGraph* hierarchy;	//per ghost queries on levels too large to flood, nullptr otherwise
+	PathPlanner pathPlanner;
+	std::vector<DStarLite*> planners;	//one per ghost, only made when the incremental planner is used
+	AIScheduler scheduler;	//spreads the path requests over the frames
+
+	/**
+	 * @brief 	The last path found for a ghost by its own query (incremental planner or
+	 * 			hierarchical graph). The ghost follows it until it reaches the end, leaves
+	 * 			it or the player changes tile, and keeps following it until the new one is served.
+	 */
+	struct GhostRoute {
+		int goalY, goalX;				//the player's tile the path leads towards
+		int y, x;						//the tile the next step is taken from
+		std::vector<FlowStep> steps;
+		size_t next;					//index of the next step
+	};
+	std::vector<GhostRoute> routes;
+
+	void generatePellets();
+	glm::vec3 findSpawn();
+	void setSpawn(SimGhost& ghost);
+	bool findSpawnTile(int id, int& y, int& x) const;
+
+	void movePlayer(const float dt);
+	void constrainPlayer(glm::vec3 oldPos);
+	void eatPellet();
+	void loadNextHopTable(const std::string& levelPath);
+	bool usesGhostRoutes() const;
+	int  tileDistance(int y, int x, int goalY, int goalX) const;
+	bool advanceRoute(GhostRoute& route, int y, int x) const;
+	bool canStep(int y, int x, FlowStep step) const;
+	void queuePathRequests();
+	void servePathRequest(int id);
+	void planRoute(int ghostIndex, int y, int x, int goalY, int goalX);
+	void moveGhost(SimGhost& ghost, const float dt);
+	void translateGhost(SimGhost& ghost, Direction dir, const float dt);
+};
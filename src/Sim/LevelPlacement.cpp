@@ -0,0 +1,68 @@
+/**
+ * @file LevelPlacement.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Places the spawns and pellets of a level, for GameSim and levelc.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "LevelPlacement.h"
+#include "../Core/GridBitboard.h"
+#include "../Core/ScenarioLoader.h"
+
+#include <algorithm>
+
+/**
+ * @brief 	Finds the spawn of the player and of every ghost ID in the level, in a single pass.
+ * 			The player spawns on the first tile with the ID 2, a ghost on the last tile with its ID.
+ *
+ * @param grid 		- The tiles of the level
+ * @param spawns 	- Set to the player (if the level has a spawn) and then the ghosts, by ID
+ */
+void placeSpawns(MazeGrid grid, std::vector<LevelSpawn>& spawns)
+{
+	std::vector<LevelSpawn> found(EMPTY_TILE, { -1, 0, 0 });
+	for (int y = 0; y < grid.getHeight(); y++)
+		for (int x = 0; x < grid.getWidth(); x++) {
+			uint8_t id = grid(y, x);
+			if (id >= 2 && id != EMPTY_TILE && (id != 2 || found[id].id == -1))
+				found[id] = { id, x, y };
+		}
+
+	spawns.clear();
+	for (const auto& spawn : found)
+		if (spawn.id != -1)
+			spawns.push_back(spawn);
+}
+
+/**
+ * @brief 	Places a pellet on every tile that is not a wall or an EMPTY_TILE, row after row.
+ * 			Tiles the player can not walk to from the spawn are left empty, the level could
+ * 			never be finished otherwise.
+ *
+ * @param grid 		- The tiles of the level
+ * @param spawnY 	- The y coordinate of the player's spawn
+ * @param spawnX 	- The x coordinate of the player's spawn
+ * @param pellets 	- Set to the tiles with a pellet
+ * @return int 		- The amount of open tiles left without a pellet
+ */
+int placePellets(MazeGrid grid, int spawnY, int spawnX, std::vector<LevelTile>& pellets)
+{
+	GridBitboard reachable(grid);
+	bool validate = reachable.floodFill(spawnY, spawnX) > 0;
+	int unreachable = 0;
+
+	pellets.clear();
+	pellets.reserve(std::count_if(grid.data(), grid.data() + grid.size(), [](uint8_t tile) { return tile != 1 && tile != EMPTY_TILE; }));
+	for (int y = 0; y < grid.getHeight(); y++)
+		for (int x = 0; x < grid.getWidth(); x++)
+			if (grid(y, x) != 1 && grid(y, x) != EMPTY_TILE) {
+				if (validate && !reachable.isReached(y, x))
+					unreachable++;
+				else
+					pellets.push_back({ x, y });
+			}
+	return unreachable;
+}
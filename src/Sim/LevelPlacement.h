@@ -0,0 +1,18 @@
+/**
+ * @file LevelPlacement.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Places the spawns and pellets of a level, for GameSim and levelc.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "../Core/MazeGrid.h"
+#include "../Core/CompiledLevel.h"
+
+#include <vector>
+
+void placeSpawns(MazeGrid grid, std::vector<LevelSpawn>& spawns);
+int  placePellets(MazeGrid grid, int spawnY, int spawnX, std::vector<LevelTile>& pellets);
@@ -0,0 +1,84 @@
+/**
+ * @file AssetPacker.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief assetpack, packs asset files and folders into one AssetPack.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "../src/Core/AssetPack.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+/**
+ * @brief Reads a file into the list of files to pack.
+ *
+ * @param path 	- The file, stored under this path with '/' between the folders
+ * @param files - The files to pack
+ * @return true - The file was read
+ */
+bool addFile(const fs::path& path, std::vector<AssetPack::File>& files)
+{
+	std::ifstream in(path, std::ios::binary);
+	if (!in) {
+		std::cerr << "assetpack: could not read " << path.generic_string() << '\n';
+		return false;
+	}
+	AssetPack::File packed;
+	packed.path = path.lexically_normal().generic_string();
+	packed.data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+	files.push_back(std::move(packed));
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	bool compress = true;
+	int first = 1;
+	if (argc > 1 && std::string(argv[1]) == "--store") {
+		compress = false;
+		first++;
+	}
+	if (argc - first < 2) {
+		std::cerr << "Usage: assetpack [--store] <pack> <file or folder>...\n"
+				  << "       Files are stored under their path relative to the working directory, the game\n"
+				  << "       looks them up with the same paths (e.g. res/maze.png). Every file is compressed\n"
+				  << "       with zlib where it helps, --store packs them all as they are.\n";
+		return EXIT_FAILURE;
+	}
+
+	std::vector<AssetPack::File> files;
+	size_t bytes = 0;
+	for (int i = first + 1; i < argc; i++) {
+		fs::path input = argv[i];
+		std::error_code error;
+		if (fs::is_directory(input, error)) {
+			for (const auto& entry : fs::recursive_directory_iterator(input))
+				if (entry.is_regular_file() && !addFile(entry.path(), files))
+					return EXIT_FAILURE;
+		}
+		else if (!addFile(input, files))
+			return EXIT_FAILURE;
+	}
+	for (const auto& packed : files)
+		bytes += packed.data.size();
+
+	size_t packedBytes = 0;
+	if (!AssetPack::save(argv[first], files, compress, &packedBytes)) {
+		std::cerr << "assetpack: could not write " << argv[first] << '\n';
+		return EXIT_FAILURE;
+	}
+	std::cout << "assetpack: " << files.size() << " files, " << bytes / 1024 << " KB -> "
+			  << argv[first] << ", " << packedBytes / 1024 << " KB\n";
+	return EXIT_SUCCESS;
+}
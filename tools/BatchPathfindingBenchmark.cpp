@@ -0,0 +1,76 @@
+/**
+ * @file BatchPathfindingBenchmark.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Measures how the BatchPathfinder scales from 1 to 64 threads on generated mazes.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "BenchmarkLevels.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 	Runs the same batch with 1, 2, 4 ... 64 threads and prints the queries per second
+ * 			and the speedup over a single thread. The results of every run are checked
+ * 			against the single threaded run.
+ *
+ * @param name 		- Printed in front of the results
+ * @param map 		- The grid to search
+ * @param queries 	- How many random queries are in the batch
+ * @param rng 		- Random generator
+ */
+void benchmark(const std::string& name, const Map& map, int queries, std::mt19937& rng)
+{
+	std::cout << name << " (" << map.width << "x" << map.height << ", " << queries << " queries)\n";
+	std::vector<PathQuery> batch = makeQueries(map, queries, rng);
+	BatchPathfinder pathfinder(map.grid(), SearchMode::Standard, 1);
+
+	std::vector<PathResult> expected, results;
+	double singleThreaded = 0.0;
+	for (unsigned int threads = 1; threads <= 64; threads *= 2) {
+		pathfinder.setThreadCount(threads);
+		pathfinder.FindPaths(batch, results);	//warm up, makes the scratch of new threads
+
+		auto begin = std::chrono::steady_clock::now();
+		pathfinder.FindPaths(batch, results);
+		auto end = std::chrono::steady_clock::now();
+
+		int mismatches = 0;
+		if (threads == 1)
+			expected = results;
+		for (size_t i = 0; i < batch.size(); i++)
+			if (results[i].length != expected[i].length ||
+				results[i].next.y != expected[i].next.y || results[i].next.x != expected[i].next.x)
+				mismatches++;
+
+		double seconds = std::chrono::duration<double>(end - begin).count();
+		double perSecond = batch.size() / seconds;
+		if (threads == 1)
+			singleThreaded = perSecond;
+		std::cout << "  " << std::setw(2) << threads << " threads"
+				  << std::fixed << std::setprecision(0) << std::setw(14) << perSecond << " queries/s"
+				  << std::setprecision(2) << std::setw(8) << perSecond / singleThreaded << "x";
+		if (mismatches)
+			std::cout << "  (" << mismatches << " results differ)";
+		std::cout << "\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	int queries = argc > 1 ? std::stoi(argv[1]) : 2000;
+	std::mt19937 rng(1234);
+
+	std::cout << std::thread::hardware_concurrency() << " hardware threads\n";
+	benchmark("corridor maze, 10% loops", makeCorridorMaze(512, 0.1f, rng), queries, rng);
+	benchmark("open level", makeOpenLevel(512, 1500, rng), queries, rng);
+	return 0;
+}
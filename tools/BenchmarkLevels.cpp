@@ -0,0 +1,148 @@
+/**
+ * @file BenchmarkLevels.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Levels and queries shared by the pathfinding benchmarks.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "BenchmarkLevels.h"
+
+#include <algorithm>
+
+/**
+ * @brief Turns a level file into the 2d grid used by the pathfinding.
+ *
+ * @param scenario 	- The loaded level file
+ * @return Map 		- The grid, 1 is a wall
+ */
+Map loadLevel(ScenarioLoader& scenario)
+{
+	int width = scenario.getHorizontalSize();
+	int height = scenario.getVerticalSize();
+	Map map(width, height, 0);
+	map.tiles.assign(scenario.getGrid().data(), scenario.getGrid().data() + map.tiles.size());
+	return map;
+}
+
+/**
+ * @brief 	Generates a maze of 1 wide corridors with a recursive backtracker, then
+ * 			knocks out some of the walls so there is more than one route between cells.
+ *
+ * @param size 		- Width and height of the maze
+ * @param loops 	- Chance of a wall between two corridors being removed
+ * @param rng 		- Random generator, seeded so every run benchmarks the same maze
+ * @return Map 		- The grid, 1 is a wall
+ */
+Map makeCorridorMaze(int size, float loops, std::mt19937& rng)
+{
+	Map map(size, size, 1);
+	const int offsetY[4] = { -2, 2, 0, 0 };
+	const int offsetX[4] = { 0, 0, -2, 2 };
+
+	std::vector<std::pair<int, int>> stack;
+	map.at(1, 1) = 0;
+	stack.push_back({ 1, 1 });
+	while (!stack.empty()) {
+		int y = stack.back().first, x = stack.back().second;
+		int options[4], count = 0;
+		for (int i = 0; i < 4; i++) {
+			int ny = y + offsetY[i], nx = x + offsetX[i];
+			if (ny > 0 && ny < size - 1 && nx > 0 && nx < size - 1 && map.at(ny, nx) == 1)
+				options[count++] = i;
+		}
+		if (count == 0) {
+			stack.pop_back();
+			continue;
+		}
+		int i = options[rng() % count];
+		map.at(y + offsetY[i] / 2, x + offsetX[i] / 2) = 0;
+		map.at(y + offsetY[i], x + offsetX[i]) = 0;
+		stack.push_back({ y + offsetY[i], x + offsetX[i] });
+	}
+
+	std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+	for (int y = 1; y < size - 1; y++)
+		for (int x = 1; x < size - 1; x++)
+			if (map.at(y, x) == 1 && (y % 2 != x % 2) && chance(rng) < loops)
+				map.at(y, x) = 0;
+	return map;
+}
+
+/**
+ * @brief Generates an open level, an empty floor with rectangular blocks of wall scattered over it.
+ *
+ * @param size 		- Width and height of the level
+ * @param blocks 	- How many blocks to place
+ * @param rng 		- Random generator, seeded so every run benchmarks the same level
+ * @return Map 		- The grid, 1 is a wall
+ */
+Map makeOpenLevel(int size, int blocks, std::mt19937& rng)
+{
+	Map map(size, size, 0);
+	for (int i = 0; i < size; i++)
+		map.at(0, i) = map.at(size - 1, i) = map.at(i, 0) = map.at(i, size - 1) = 1;
+
+	std::uniform_int_distribution<int> position(1, size - 2), extent(1, 12);
+	for (int b = 0; b < blocks; b++) {
+		int y = position(rng), x = position(rng);
+		int h = extent(rng), w = extent(rng);
+		for (int by = y; by < std::min(y + h, size - 1); by++)
+			for (int bx = x; bx < std::min(x + w, size - 1); bx++)
+				map.at(by, bx) = 1;
+	}
+	return map;
+}
+
+/**
+ * @brief 	Picks random pairs of walkable cells that are connected. The cells are labelled
+ * 			with a flood fill first, so no query is spent on a pair without a path.
+ *
+ * @param map 		- The grid to pick cells from
+ * @param count 	- How many queries to make
+ * @param rng 		- Random generator
+ * @return std::vector<PathQuery>
+ */
+std::vector<PathQuery> makeQueries(const Map& map, int count, std::mt19937& rng)
+{
+	int height = map.height, width = map.width;
+	std::vector<int> component(height * width, -1);
+	std::vector<int> cells, stack;
+	for (int i = 0; i < height * width; i++) {
+		if (map.tiles[i] == 1 || component[i] != -1)
+			continue;
+		component[i] = i;
+		stack.push_back(i);
+		while (!stack.empty()) {
+			int cell = stack.back();
+			stack.pop_back();
+			cells.push_back(cell);
+			int y = cell / width, x = cell % width;
+			const int next[4][2] = { { y - 1, x }, { y + 1, x }, { y, x - 1 }, { y, x + 1 } };
+			for (auto& n : next)
+				if (n[0] >= 0 && n[0] < height && n[1] >= 0 && n[1] < width &&
+					map.at(n[0], n[1]) != 1 && component[n[0] * width + n[1]] == -1) {
+					component[n[0] * width + n[1]] = i;
+					stack.push_back(n[0] * width + n[1]);
+				}
+		}
+	}
+
+	std::vector<PathQuery> queries;
+	std::uniform_int_distribution<size_t> pick(0, cells.size() - 1);
+	while ((int)queries.size() < count) {
+		int start = cells[pick(rng)];
+		int goal = cells[pick(rng)];
+		if (start == goal || component[start] != component[goal])
+			continue;
+		PathQuery query = {};
+		query.start.y = start / width;
+		query.start.x = start % width;
+		query.destination.y = goal / width;
+		query.destination.x = goal % width;
+		queries.push_back(query);
+	}
+	return queries;
+}
@@ -0,0 +1,38 @@
+/**
+ * @file BenchmarkLevels.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Levels and queries shared by the pathfinding benchmarks.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include "../src/Core/BatchPathfinder.h"
+#include "../src/Core/ScenarioLoader.h"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+/**
+ * @brief A level made for the benchmarks, owning its tiles. The pathfinding is given a MazeGrid of them.
+ */
+struct Map {
+	int width,
+		height;
+	std::vector<uint8_t> tiles;	//row after row, 1 is a wall
+
+	Map(int width, int height, uint8_t tile)
+		: width(width), height(height), tiles((size_t)width * height, tile) {}
+
+	inline uint8_t& at(int y, int x) { return tiles[(size_t)y * width + x]; }
+	inline uint8_t at(int y, int x) const { return tiles[(size_t)y * width + x]; }
+	inline MazeGrid grid() const { return MazeGrid(tiles.data(), width, height); }
+};
+
+Map loadLevel(ScenarioLoader& scenario);
+Map makeCorridorMaze(int size, float loops, std::mt19937& rng);
+Map makeOpenLevel(int size, int blocks, std::mt19937& rng);
+std::vector<PathQuery> makeQueries(const Map& map, int count, std::mt19937& rng);
@@ -0,0 +1,98 @@
+/**
+ * @file CompileLevel.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Compiles a level file with everything derived from it into a CompiledLevel, for levelc and mazegen.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "CompileLevel.h"
+#include "../src/Core/CompiledLevel.h"
+#include "../src/Core/LevelGeometry.h"
+#include "../src/Core/NextHopTable.h"
+#include "../src/Core/ScenarioLoader.h"
+#include "../src/Sim/LevelPlacement.h"
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+/**
+ * @brief 	Compiles one level. The spawns and pellets are placed exactly like GameSim places
+ * 			them when the level is parsed at startup, and the next hop table is built if the
+ * 			game would precompute it. What is cheap to derive at load time (the minimap
+ * 			positions, the pellet matrices) is not stored, and streamed levels get neither
+ * 			the maze mesh nor the minimap indices, they are built around the player while playing.
+ *
+ * @param levelPath 	- The level file
+ * @param outputPath 	- Where to write the compiled level
+ * @return true 		- The level was compiled
+ */
+bool compileLevel(const std::string& levelPath, const std::string& outputPath)
+{
+	auto begin = std::chrono::steady_clock::now();
+	ScenarioLoader level(levelPath, false);
+	if (!level.isLoaded())
+		return false;
+
+	int width = level.getHorizontalSize();
+	int height = level.getVerticalSize();
+	MazeGrid grid = level.getGrid();
+
+	std::vector<LevelSpawn> spawns;
+	placeSpawns(grid, spawns);
+	int spawnY = 0, spawnX = 0;
+	if (!spawns.empty() && spawns[0].id == 2) {
+		spawnY = spawns[0].y;
+		spawnX = spawns[0].x;
+	}
+	std::vector<LevelTile> pellets;
+	placePellets(grid, spawnY, spawnX, pellets);
+
+	std::vector<Vertex> mazeVertices;
+	std::vector<unsigned int> mazeIndices, minimapIndices;
+	std::vector<MeshChunk> mazeChunks;
+	if (!isStreamedLevel(width, height)) {
+		makeMazeMesh(grid, mazeVertices, mazeIndices, mazeChunks);
+		makeMinimapIndices(grid, { 0, 0, width, height }, minimapIndices);
+	}
+
+	std::vector<unsigned char> nextHop;
+	if (NextHopTable::fitsInMemory(NextHopTable::countCells(grid), NextHopTable::DEFAULT_MAX_BYTES)) {
+		NextHopTable table(grid);
+		table.build();
+		table.serialize(nextHop);
+	}
+
+	std::vector<CompiledLevel::Section> sections = {
+		{ LevelSection::Tiles,		sizeof(uint8_t),	grid.data(),	(size_t)width * height },
+		{ LevelSection::Spawns,		sizeof(LevelSpawn),	spawns.data(),	spawns.size() },
+		{ LevelSection::Pellets,	sizeof(LevelTile),	pellets.data(),	pellets.size() }
+	};
+	if (!mazeIndices.empty()) {
+		sections.push_back({ LevelSection::MazeVertices, sizeof(Vertex), mazeVertices.data(), mazeVertices.size() });
+		sections.push_back({ LevelSection::MazeIndices, sizeof(unsigned int), mazeIndices.data(), mazeIndices.size() });
+		sections.push_back({ LevelSection::MazeChunks, sizeof(MeshChunk), mazeChunks.data(), mazeChunks.size() });
+	}
+	if (!minimapIndices.empty())
+		sections.push_back({ LevelSection::MinimapIndices, sizeof(unsigned int), minimapIndices.data(), minimapIndices.size() });
+	if (!nextHop.empty())
+		sections.push_back({ LevelSection::NextHopTable, sizeof(unsigned char), nextHop.data(), nextHop.size() });
+
+	if (!CompiledLevel::save(outputPath, width, height, sections)) {
+		std::cerr << "levelc: could not write " << outputPath << '\n';
+		return false;
+	}
+
+	size_t bytes = 0;
+	for (const auto& section : sections)
+		bytes += section.elementSize * section.count;
+	auto end = std::chrono::steady_clock::now();
+	std::cout << "levelc: " << levelPath << " (" << width << "x" << height << ", " << spawns.size() << " spawns, "
+			  << pellets.size() << " pellets" << (nextHop.empty() ? "" : ", next hop table") << ") -> "
+			  << outputPath << ", " << bytes / 1024 << " KB in "
+			  << std::chrono::duration<double, std::milli>(end - begin).count() << " ms\n";
+	return true;
+}
@@ -0,0 +1,14 @@
+/**
+ * @file CompileLevel.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Compiles a level file with everything derived from it into a CompiledLevel, for levelc and mazegen.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <string>
+
+bool compileLevel(const std::string& levelPath, const std::string& outputPath);
@@ -0,0 +1,120 @@
+/**
+ * @file GpuDistanceFieldCheck.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Checks the GpuDistanceField against the breadth first search on the cpu, and times both.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "BenchmarkLevels.h"
+#include "../src/Core/GpuDistanceField.h"
+#include "../src/Core/GridBitboard.h"
+
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+/**
+ * @brief 	Builds the distance field towards random goals on the gpu and the cpu and
+ * 			compares them, then checks that every route read back walks down the field.
+ *
+ * @param name 	- Printed in front of the results
+ * @param map 	- The grid to search
+ * @param goals - How many goals to check
+ * @param rng 	- Random generator
+ * @return int 	- The amount of goals where anything differed
+ */
+int check(const std::string& name, const Map& map, int goals, std::mt19937& rng)
+{
+	const int offsetY[4] = { -1, 1, 0, 0 };	//same order as FlowStep
+	const int offsetX[4] = { 0, 0, -1, 1 };
+	const int routeSteps = 16;
+	int height = map.height, width = map.width;
+
+	GpuDistanceField gpu(map.grid());
+	GridBitboard cpu(map.grid());
+	std::vector<PathQuery> queries = makeQueries(map, goals, rng);
+	std::vector<int> gpuDistance, cpuDistance(height * width);
+	std::vector<FlowStep> steps;
+
+	int failed = 0, passes = 0;
+	double gpuTime = 0.0, cpuTime = 0.0;
+	for (const auto& query : queries) {
+		int goalY = query.destination.y, goalX = query.destination.x;
+
+		auto begin = std::chrono::steady_clock::now();
+		passes += gpu.build(goalY, goalX);
+		gpu.getDistances(gpuDistance);
+		auto middle = std::chrono::steady_clock::now();
+		cpu.distanceField(goalY, goalX, cpuDistance);
+		auto end = std::chrono::steady_clock::now();
+		gpuTime += std::chrono::duration<double, std::milli>(middle - begin).count();
+		cpuTime += std::chrono::duration<double, std::milli>(end - middle).count();
+
+		bool ok = gpuDistance == cpuDistance;
+		std::vector<int> startY(1, query.start.y), startX(1, query.start.x);
+		gpu.getRoutes(startY, startX, routeSteps, steps);
+		int y = query.start.y, x = query.start.x;
+		for (int s = 0; s < routeSteps && ok && cpuDistance[y * width + x] > 0; s++) {
+			if (steps[s] == StepNone) {
+				ok = false;
+				break;
+			}
+			int nextY = y + offsetY[steps[s]];
+			int nextX = (x + offsetX[steps[s]] + width) % width;
+			ok = cpuDistance[nextY * width + nextX] == cpuDistance[y * width + x] - 1;
+			y = nextY;
+			x = nextX;
+		}
+		if (!ok)
+			failed++;
+	}
+
+	std::cout << "  " << std::left << std::setw(28) << name << std::right << std::fixed << std::setprecision(2)
+			  << std::setw(10) << gpuTime / goals << " ms gpu (" << (double)passes / goals << " passes)"
+			  << std::setw(10) << cpuTime / goals << " ms cpu"
+			  << "  " << failed << "/" << goals << " differ\n";
+	return failed;
+}
+
+int main(int argc, char** argv)
+{
+	int size = argc > 1 ? std::stoi(argv[1]) : 512;
+	std::mt19937 rng(1234);
+
+	if (!glfwInit()) {
+		std::cerr << "GLFW initialization failed." << '\n';
+		return EXIT_FAILURE;
+	}
+	glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	GLFWwindow* window = glfwCreateWindow(64, 64, "GPU distance field check", nullptr, nullptr);
+	if (window == nullptr) {
+		std::cerr << "GLFW failed on window creation." << '\n';
+		glfwTerminate();
+		return EXIT_FAILURE;
+	}
+	glfwMakeContextCurrent(window);
+	glewExperimental = GL_TRUE;
+	if (glewInit() != GLEW_OK || !GpuDistanceField::isSupported()) {
+		std::cerr << "No GL 4.3 context available." << '\n';
+		glfwTerminate();
+		return EXIT_FAILURE;
+	}
+	std::cout << glGetString(GL_RENDERER) << "\n";
+
+	int failed = 0;
+	failed += check("corridor maze, 10% loops", makeCorridorMaze(size, 0.1f, rng), 8, rng);
+	failed += check("open level", makeOpenLevel(size, size * 3, rng), 8, rng);
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+	return failed == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
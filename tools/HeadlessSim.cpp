@@ -0,0 +1,78 @@
+/**
+ * @file HeadlessSim.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief headless_sim, plays a level without a window with the player holding one direction, for repeatable checks of the game logic.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "../src/Sim/GameSim.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace {
+	const float SIM_TIMESTEP = 1.f / 120.f;	//the same fixed step as the game
+}
+
+int main(int argc, char** argv)
+{
+	std::string levelPath = "levels/level0";
+	std::string hold = "right";
+	unsigned long long maxTicks = 100000;
+	bool valid = true;
+
+	for (int i = 1; i < argc && valid; i++) {
+		std::string option = argv[i];
+		if (option.compare(0, 2, "--") != 0)
+			levelPath = option;
+		else if (i + 1 == argc)
+			valid = false;
+		else if (option == "--hold")
+			hold = argv[++i];
+		else if (option == "--max-ticks")
+			maxTicks = std::strtoull(argv[++i], nullptr, 10);
+		else
+			valid = false;
+	}
+
+	//World space, the same vectors the camera gives when looking along the axes
+	glm::vec3 wishMove(0.f);
+	if (hold == "right")
+		wishMove = glm::vec3(1.f, 0.f, 0.f);
+	else if (hold == "left")
+		wishMove = glm::vec3(-1.f, 0.f, 0.f);
+	else if (hold == "down")
+		wishMove = glm::vec3(0.f, 0.f, 1.f);
+	else if (hold == "up")
+		wishMove = glm::vec3(0.f, 0.f, -1.f);
+	else if (hold != "none")
+		valid = false;
+
+	if (!valid) {
+		std::cerr << "usage: headless_sim [level] [--hold right|left|up|down|none] [--max-ticks <n>]\n";
+		return 1;
+	}
+
+	ScenarioLoader level(levelPath);
+	if (!level.isLoaded())
+		return 1;
+
+	GameSim sim(&level, level.countGhosts());
+	sim.setPlayerInput(wishMove);
+	auto begin = std::chrono::steady_clock::now();
+	while (!sim.isGameOver() && sim.getTickCount() < maxTicks)
+		sim.tick(SIM_TIMESTEP);
+	auto end = std::chrono::steady_clock::now();
+
+	std::cout << levelPath << ": tick " << sim.getTickCount() << ", "
+			  << (sim.isPlayerEaten() ? "player eaten" : sim.allPelletsEaten() ? "all pellets eaten" : "still playing") << ", "
+			  << sim.getRemainingPellets() << " of " << sim.getPelletCount() << " pellets left, player at "
+			  << sim.getPlayer().position.x << ", " << sim.getPlayer().position.z << " ("
+			  << std::chrono::duration<double, std::milli>(end - begin).count() << " ms)\n";
+	return 0;
+}
@@ -0,0 +1,29 @@
+/**
+ * @file LevelCompiler.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief levelc, compiles a level file with everything derived from it into a CompiledLevel.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "CompileLevel.h"
+#include "../src/Core/CompiledLevel.h"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv)
+{
+	if (argc < 2) {
+		std::cerr << "Usage: levelc <level> [<compiled level>]\n"
+				  << "       The compiled level is written to <level>.lvlc by default.\n";
+		return EXIT_FAILURE;
+	}
+
+	std::string levelPath = argv[1];
+	std::string outputPath = argc > 2 ? argv[2] : CompiledLevel::pathFor(levelPath);
+	return compileLevel(levelPath, outputPath) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
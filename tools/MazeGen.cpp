@@ -0,0 +1,131 @@
+/**
+ * @file MazeGen.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief mazegen, writes generated pacman style levels for benchmarks and stress tests.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "MazeGenerator.h"
+#include "CompileLevel.h"
+#include "../src/Core/CompiledLevel.h"
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Reads a whole number given on the command line.
+ *
+ * @param text 	- The argument
+ * @param value - Set to the number
+ * @param limit - The largest value accepted
+ * @return true - The whole argument is a number up to the limit
+ */
+template<typename T>
+bool readInteger(const char* text, T& value, unsigned long long limit = INT_MAX)
+{
+	char* end = nullptr;
+	errno = 0;
+	unsigned long long number = std::strtoull(text, &end, 10);
+	if (end == text || *end != '\0' || *text == '-' || errno != 0 || number > limit)
+		return false;
+	value = (T)number;
+	return true;
+}
+
+/**
+ * @brief Reads a fraction given on the command line.
+ *
+ * @param text 	- The argument
+ * @param value - Set to the fraction
+ * @return true - The whole argument is a number
+ */
+bool readFraction(const char* text, float& value)
+{
+	char* end = nullptr;
+	value = std::strtof(text, &end);
+	return end != text && *end == '\0';
+}
+
+int main(int argc, char** argv)
+{
+	MazeSettings settings;
+	std::string levelPath;
+	bool compile = false;
+	bool valid = argc > 1;
+
+	for (int i = 1; i < argc && valid; i++) {
+		std::string option = argv[i];
+		if (option == "--compile")
+			compile = true;
+		else if (option.compare(0, 2, "--") != 0) {
+			valid = levelPath.empty();
+			levelPath = option;
+		}
+		else if (i + 1 == argc)
+			valid = false;
+		else if (option == "--size") {
+			std::string value = argv[++i];
+			size_t times = value.find('x');
+			if (times == std::string::npos)
+				valid = readInteger(value.c_str(), settings.width) && readInteger(value.c_str(), settings.height);
+			else
+				valid = readInteger(value.substr(0, times).c_str(), settings.width) &&
+						readInteger(value.substr(times + 1).c_str(), settings.height);
+		}
+		else if (option == "--seed")
+			valid = readInteger(argv[++i], settings.seed, ULLONG_MAX);
+		else if (option == "--corridors")
+			valid = readFraction(argv[++i], settings.corridors);
+		else if (option == "--tunnels")
+			valid = readInteger(argv[++i], settings.tunnels);
+		else if (option == "--ghosts")
+			valid = readInteger(argv[++i], settings.ghosts);
+		else if (option == "--pellets")
+			valid = readFraction(argv[++i], settings.pellets);
+		else if (option == "--threads")
+			valid = readInteger(argv[++i], settings.threads, 1024);
+		else
+			valid = false;
+	}
+	if (!valid || levelPath.empty()) {
+		std::cerr << "Usage: mazegen <level> [--size <width>x<height>] [--seed <n>] [--corridors <0-1>] [--tunnels <n>]\n"
+				  << "               [--ghosts <n>] [--pellets <0-1>] [--threads <n>] [--compile]\n"
+				  << "       Writes a pacman style level, 28x36 with 3 ghosts by default. The same settings and seed\n"
+				  << "       give the same level on any number of threads. --corridors is the chance of removing a\n"
+				  << "       wall between two corridors the maze does not need, --pellets the chance of a corridor\n"
+				  << "       tile having a pellet. --compile also compiles it into <level>.lvlc like levelc does.\n";
+		return EXIT_FAILURE;
+	}
+
+	std::string error = checkMazeSettings(settings);
+	if (!error.empty()) {
+		std::cerr << "mazegen: " << error << '\n';
+		return EXIT_FAILURE;
+	}
+
+	auto begin = std::chrono::steady_clock::now();
+	std::vector<uint8_t> tiles;
+	generateMaze(settings, tiles);
+	auto generated = std::chrono::steady_clock::now();
+	if (!writeLevel(levelPath, settings.width, settings.height, tiles, settings.threads)) {
+		std::cerr << "mazegen: could not write " << levelPath << '\n';
+		return EXIT_FAILURE;
+	}
+	auto written = std::chrono::steady_clock::now();
+
+	std::cout << "mazegen: " << levelPath << " (" << settings.width << "x" << settings.height << ", seed " << settings.seed
+			  << ") generated in " << std::chrono::duration<double, std::milli>(generated - begin).count() << " ms, written in "
+			  << std::chrono::duration<double, std::milli>(written - generated).count() << " ms\n";
+
+	if (compile && !compileLevel(levelPath, CompiledLevel::pathFor(levelPath)))
+		return EXIT_FAILURE;
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,412 @@
+/**
+ * @file MazeGenerator.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Generates pacman style levels of any size, for benchmarks and stress tests.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "MazeGenerator.h"
+#include "../src/Core/ScenarioLoader.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <thread>
+
+namespace {
+	const int MIN_SIZE = 8;
+	const int MAX_SIZE = MAX_LEVEL_SIDE;	//the largest level ScenarioLoader accepts
+	const int BLOCK_CELLS = 64;			//the corridors of every block of 64x64 cells are carved on their own
+	const int WRITE_ROWS = 256;			//rows every thread formats before they are written
+	const uint64_t GAMMA = 0x9E3779B97F4A7C15ull;
+	const uint64_t SALT_BLOCKS = 1, SALT_LINKS = 2, SALT_CORRIDORS = 3, SALT_DEAD_ENDS = 4, SALT_PELLETS = 5;
+	const int offsetY[4] = { -1, 1, 0, 0 };
+	const int offsetX[4] = { 0, 0, -1, 1 };
+
+	/**
+	 * @brief The finalizer of splitmix64, every bit of the result depends on every bit of x.
+	 */
+	uint64_t mix(uint64_t x)
+	{
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+	/**
+	 * @brief 	Random numbers looked up by index, the same however many were drawn before,
+	 * 			so the tiles decided by them can be split over threads in any way.
+	 */
+	struct Stream {
+		uint64_t key;
+
+		Stream(uint64_t seed, uint64_t salt) : key(mix(seed ^ mix(salt * GAMMA))) {}
+		uint64_t at(uint64_t i) const { return mix(key + (i + 1) * GAMMA); }
+		float chance(uint64_t i) const { return (float)(at(i) >> 40) * (1.0f / 16777216.0f); }
+	};
+
+	/**
+	 * @brief Random numbers one after another (splitmix64), for what a single thread carves.
+	 */
+	struct Random {
+		uint64_t state;
+
+		explicit Random(uint64_t seed) : state(seed) {}
+		uint32_t next(uint32_t range) { state += GAMMA; return (uint32_t)(((mix(state) >> 32) * range) >> 32); }
+	};
+
+	/**
+	 * @brief Runs work(i) for every i below count, every thread takes every threadCount'th i.
+	 */
+	template<typename Work>
+	void parallelFor(int count, unsigned int threadCount, Work work)
+	{
+		threadCount = std::max(1u, std::min(threadCount, (unsigned int)std::max(count, 0)));
+		auto worker = [&work, count, threadCount](unsigned int first) {
+			for (int i = first; i < count; i += threadCount)
+				work(i);
+		};
+
+		std::vector<std::thread> threads;
+		for (unsigned int i = 1; i < threadCount; i++)
+			threads.emplace_back(worker, i);
+		worker(0);
+		for (auto& thread : threads)
+			thread.join();
+	}
+
+	/**
+	 * @brief 	The level being generated. The corridors run through the tiles with odd
+	 * 			coordinates (the cells), the tiles between two cells are either wall or
+	 * 			corridor. A wall is one tile thick, so every corridor is one tile wide.
+	 */
+	struct Maze {
+		const MazeSettings& settings;
+		std::vector<uint8_t>& tiles;
+		int width, height;
+		int cellsX, cellsY;
+		int blocksX, blocksY;
+		unsigned int threads;
+
+		Maze(const MazeSettings& settings, std::vector<uint8_t>& tiles)
+			:	settings(settings),
+				tiles(tiles),
+				width(settings.width),
+				height(settings.height),
+				cellsX((settings.width - 1) / 2),
+				cellsY((settings.height - 1) / 2),
+				blocksX((cellsX + BLOCK_CELLS - 1) / BLOCK_CELLS),
+				blocksY((cellsY + BLOCK_CELLS - 1) / BLOCK_CELLS),
+				threads(settings.threads ? settings.threads : std::max(1u, std::thread::hardware_concurrency()))
+		{
+		}
+
+		uint8_t& tile(int x, int y) { return tiles[(size_t)y * width + x]; }
+		uint8_t& cell(int cx, int cy) { return tile(2 * cx + 1, 2 * cy + 1); }
+
+		void carveBlock(int block, std::vector<uint8_t>& visited, std::vector<int>& stack);
+		void linkBlocks();
+		void removeWalls();
+		void removeDeadEnds();
+		void openTunnels();
+		void placeSpawns();
+		void removePellets();
+	};
+
+	/**
+	 * @brief 	Carves a spanning tree of corridors through the cells of one block with a
+	 * 			recursive backtracker. Touches only the tiles inside the block, so the
+	 * 			blocks are carved in parallel.
+	 *
+	 * @param block 	- The block, row after row
+	 * @param visited 	- Scratch buffer of the thread
+	 * @param stack 	- Scratch buffer of the thread
+	 */
+	void Maze::carveBlock(int block, std::vector<uint8_t>& visited, std::vector<int>& stack)
+	{
+		int firstX = block % blocksX * BLOCK_CELLS, firstY = block / blocksX * BLOCK_CELLS;
+		int sizeX = std::min(BLOCK_CELLS, cellsX - firstX), sizeY = std::min(BLOCK_CELLS, cellsY - firstY);
+		Random random(Stream(settings.seed, SALT_BLOCKS).at(block));
+
+		visited.assign(sizeX * sizeY, 0);
+		stack.clear();
+		int start = random.next(sizeX * sizeY);
+		visited[start] = 1;
+		cell(firstX + start % sizeX, firstY + start / sizeX) = 0;
+		stack.push_back(start);
+		while (!stack.empty()) {
+			int x = stack.back() % sizeX, y = stack.back() / sizeX;
+			int options[4], count = 0;
+			for (int i = 0; i < 4; i++) {
+				int nx = x + offsetX[i], ny = y + offsetY[i];
+				if (nx >= 0 && nx < sizeX && ny >= 0 && ny < sizeY && !visited[ny * sizeX + nx])
+					options[count++] = i;
+			}
+			if (count == 0) {
+				stack.pop_back();
+				continue;
+			}
+
+			int i = options[random.next(count)];
+			int tileX = 2 * (firstX + x) + 1, tileY = 2 * (firstY + y) + 1;
+			tile(tileX + offsetX[i], tileY + offsetY[i]) = 0;
+			tile(tileX + 2 * offsetX[i], tileY + 2 * offsetY[i]) = 0;
+			visited[(y + offsetY[i]) * sizeX + x + offsetX[i]] = 1;
+			stack.push_back((y + offsetY[i]) * sizeX + x + offsetX[i]);
+		}
+	}
+
+	/**
+	 * @brief 	Connects the blocks with a spanning tree of their own, every link opens the
+	 * 			wall between two cells on the border of the blocks, so every cell can reach
+	 * 			every other one.
+	 */
+	void Maze::linkBlocks()
+	{
+		Random random(Stream(settings.seed, SALT_LINKS).at(0));
+		std::vector<bool> visited(blocksX * blocksY, false);
+		std::vector<int> stack = { 0 };
+		visited[0] = true;
+		while (!stack.empty()) {
+			int x = stack.back() % blocksX, y = stack.back() / blocksX;
+			int options[4], count = 0;
+			for (int i = 0; i < 4; i++) {
+				int nx = x + offsetX[i], ny = y + offsetY[i];
+				if (nx >= 0 && nx < blocksX && ny >= 0 && ny < blocksY && !visited[ny * blocksX + nx])
+					options[count++] = i;
+			}
+			if (count == 0) {
+				stack.pop_back();
+				continue;
+			}
+
+			int i = options[random.next(count)];
+			int nx = x + offsetX[i], ny = y + offsetY[i];
+			if (offsetX[i] != 0) {
+				int column = (std::max(x, nx) * BLOCK_CELLS) * 2;
+				int row = y * BLOCK_CELLS + random.next(std::min(BLOCK_CELLS, cellsY - y * BLOCK_CELLS));
+				tile(column, 2 * row + 1) = 0;
+			}
+			else {
+				int row = (std::max(y, ny) * BLOCK_CELLS) * 2;
+				int column = x * BLOCK_CELLS + random.next(std::min(BLOCK_CELLS, cellsX - x * BLOCK_CELLS));
+				tile(2 * column + 1, row) = 0;
+			}
+			visited[ny * blocksX + nx] = true;
+			stack.push_back(ny * blocksX + nx);
+		}
+	}
+
+	/**
+	 * @brief Removes walls between two cells by chance, the loops that make it a pacman maze and not a labyrinth.
+	 *
+	 */
+	void Maze::removeWalls()
+	{
+		if (settings.corridors <= 0.0f)
+			return;
+		Stream stream(settings.seed, SALT_CORRIDORS);
+		parallelFor(2 * cellsY - 1, threads, [this, &stream](int row) {
+			int y = row + 1;
+			//Rows of cells have walls between two columns, the rows between them between two rows
+			for (int x = (y % 2 == 1 ? 2 : 1); x < 2 * cellsX; x += 2) {
+				size_t i = (size_t)y * width + x;
+				if (tiles[i] == 1 && stream.chance(i) < settings.corridors)
+					tiles[i] = 0;
+			}
+		});
+	}
+
+	/**
+	 * @brief 	Opens one more wall of every cell with only one way out, pacman mazes have no
+	 * 			dead ends. A wall lies between a cell of each colour of a checkerboard, so
+	 * 			the cells of one colour are done in parallel without two threads deciding
+	 * 			over the same wall, and the result does not depend on the order.
+	 */
+	void Maze::removeDeadEnds()
+	{
+		Stream stream(settings.seed, SALT_DEAD_ENDS);
+		for (int colour = 0; colour < 2; colour++)
+			parallelFor(cellsY, threads, [this, &stream, colour](int cy) {
+				for (int cx = (cy + colour) % 2; cx < cellsX; cx += 2) {
+					int closed[4], count = 0, open = 0;
+					for (int i = 0; i < 4; i++) {
+						int nx = cx + offsetX[i], ny = cy + offsetY[i];
+						if (nx < 0 || nx >= cellsX || ny < 0 || ny >= cellsY)
+							continue;
+						if (tile(2 * cx + 1 + offsetX[i], 2 * cy + 1 + offsetY[i]) == 0)
+							open++;
+						else
+							closed[count++] = i;
+					}
+					if (open <= 1 && count > 0) {
+						int i = closed[stream.at((size_t)cy * cellsX + cx) % count];
+						tile(2 * cx + 1 + offsetX[i], 2 * cy + 1 + offsetY[i]) = 0;
+					}
+				}
+			});
+	}
+
+	/**
+	 * @brief Opens the outer walls of evenly spaced rows of cells on both sides.
+	 *
+	 */
+	void Maze::openTunnels()
+	{
+		for (int i = 0; i < settings.tunnels; i++) {
+			int y = 2 * ((2 * i + 1) * cellsY / (2 * settings.tunnels)) + 1;
+			tile(0, y) = 0;
+			for (int x = 2 * cellsX; x < width; x++)
+				tile(x, y) = 0;
+		}
+	}
+
+	/**
+	 * @brief 	Opens the ghost house in the middle of the level, square and large enough for
+	 * 			every ghost, without pellets. The player spawns on the closest cell below it.
+	 */
+	void Maze::placeSpawns()
+	{
+		int side = std::max(3, (int)std::ceil(std::sqrt((double)settings.ghosts)));
+		int houseX = (width - side) / 2, houseY = (height - side) / 2;
+		for (int y = houseY; y < houseY + side; y++)
+			for (int x = houseX; x < houseX + side; x++)
+				tile(x, y) = EMPTY_TILE;
+		for (int i = 0; i < settings.ghosts; i++)
+			tile(houseX + i % side, houseY + i / side) = (uint8_t)(3 + i);
+
+		//The house covers at most half of the rows, so there is always a cell outside of it
+		int cx = std::min(cellsX - 1, width / 4), below = (houseY + side) / 2;
+		for (int step = 0; ; step++) {
+			if (below + step < cellsY && cell(cx, below + step) == 0) {
+				cell(cx, below + step) = 2;
+				return;
+			}
+			if (below - step >= 0 && cell(cx, below - step) == 0) {
+				cell(cx, below - step) = 2;
+				return;
+			}
+		}
+	}
+
+	/**
+	 * @brief Leaves corridor tiles without a pellet by chance.
+	 *
+	 */
+	void Maze::removePellets()
+	{
+		if (settings.pellets >= 1.0f)
+			return;
+		Stream stream(settings.seed, SALT_PELLETS);
+		parallelFor(height, threads, [this, &stream](int y) {
+			for (size_t i = (size_t)y * width; i < (size_t)(y + 1) * width; i++)
+				if (tiles[i] == 0 && stream.chance(i) >= settings.pellets)
+					tiles[i] = EMPTY_TILE;
+		});
+	}
+
+	/**
+	 * @brief Appends a tile to a row of a level file.
+	 */
+	void appendValue(std::string& text, uint8_t value)
+	{
+		if (value >= 100)
+			text += (char)('0' + value / 100);
+		if (value >= 10)
+			text += (char)('0' + value / 10 % 10);
+		text += (char)('0' + value % 10);
+	}
+}
+
+/**
+ * @brief Checks the settings before generating.
+ *
+ * @param settings 		- What to generate
+ * @return std::string 	- What is wrong with the settings, empty if nothing is
+ */
+std::string checkMazeSettings(const MazeSettings& settings)
+{
+	if (settings.width < MIN_SIZE || settings.height < MIN_SIZE || settings.width > MAX_SIZE || settings.height > MAX_SIZE)
+		return "the size has to be from " + std::to_string(MIN_SIZE) + " to " + std::to_string(MAX_SIZE) + " tiles";
+	if (!(settings.corridors >= 0.0f && settings.corridors <= 1.0f))
+		return "the corridor density has to be from 0 to 1";
+	if (!(settings.pellets >= 0.0f && settings.pellets <= 1.0f))
+		return "the pellet density has to be from 0 to 1";
+	if (settings.tunnels < 0 || settings.tunnels > (settings.height - 1) / 2)
+		return "the level has room for up to " + std::to_string((settings.height - 1) / 2) + " tunnels";
+	if (settings.ghosts < 0 || settings.ghosts > EMPTY_TILE - 3)
+		return "the ghosts use the IDs 3 to " + std::to_string(EMPTY_TILE - 1) + ", up to " + std::to_string(EMPTY_TILE - 3) + " ghosts";
+	int side = std::max(3, (int)std::ceil(std::sqrt((double)settings.ghosts)));
+	if (side > std::min(settings.width, settings.height) / 2)
+		return "the level is too small for a ghost house of " + std::to_string(settings.ghosts) + " ghosts";
+	return "";
+}
+
+/**
+ * @brief 	Generates a level: corridors without dead ends, one tile wide, connecting every
+ * 			part of the level, tunnels wrapping around the sides, a ghost house in the middle
+ * 			and the player's spawn below it. The corridors of blocks of cells are carved in
+ * 			parallel and then linked, and every random choice made in parallel is looked up
+ * 			by the tile it is about, so the level only depends on the settings and the seed.
+ *
+ * @param settings 	- What to generate, checked with checkMazeSettings
+ * @param tiles 	- Set to the level, row after row
+ */
+void generateMaze(const MazeSettings& settings, std::vector<uint8_t>& tiles)
+{
+	tiles.assign((size_t)settings.width * settings.height, 1);
+	Maze maze(settings, tiles);
+
+	parallelFor(maze.blocksY, maze.threads, [&maze](int blockRow) {
+		std::vector<uint8_t> visited;
+		std::vector<int> stack;
+		for (int block = blockRow * maze.blocksX; block < (blockRow + 1) * maze.blocksX; block++)
+			maze.carveBlock(block, visited, stack);
+	});
+	maze.linkBlocks();
+	maze.removeWalls();
+	maze.removeDeadEnds();
+	maze.openTunnels();
+	maze.placeSpawns();
+	maze.removePellets();
+}
+
+/**
+ * @brief 	Writes a level file the ScenarioLoader reads: the size, then one line of values
+ * 			per row. The rows are formatted in parallel and written in order.
+ *
+ * @param path 		- The level file
+ * @param width 	- The width of the level
+ * @param height 	- The height of the level
+ * @param tiles 	- The level, row after row
+ * @param threads 	- How many threads format the rows, 0 uses one per hardware thread
+ * @return true 	- The file was written
+ */
+bool writeLevel(const std::string& path, int width, int height, const std::vector<uint8_t>& tiles, unsigned int threads)
+{
+	std::ofstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+	file << width << 'x' << height << '\n';
+
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<std::string> parts(threads);
+	for (int first = 0; first < height; first += WRITE_ROWS * threads) {
+		parallelFor(threads, threads, [&](int part) {
+			std::string& text = parts[part];
+			text.clear();
+			for (int y = first + part * WRITE_ROWS; y < std::min(height, first + (part + 1) * WRITE_ROWS); y++)
+				for (int x = 0; x < width; x++) {
+					appendValue(text, tiles[(size_t)y * width + x]);
+					text += x + 1 < width ? ' ' : '\n';
+				}
+		});
+		for (const auto& text : parts)
+			file.write(text.data(), text.size());
+	}
+	return file.good();
+}
@@ -0,0 +1,33 @@
+/**
+ * @file MazeGenerator.h
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Generates pacman style levels of any size, for benchmarks and stress tests.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 	What to generate. The same settings give the same level, whatever the number
+ * 			of threads.
+ */
+struct MazeSettings {
+	int				width		= 28,
+					height		= 36;
+	uint64_t		seed		= 1;
+	float			corridors	= 0.2f;	//chance of removing a wall between two corridors the maze does not need
+	int				tunnels		= 1;	//rows open at both sides, wrapping around like the tunnel in level0
+	int				ghosts		= 3;	//IDs 3 up to 2 + ghosts, placed in a ghost house in the middle
+	float			pellets		= 1.0f;	//chance of a corridor tile having a pellet, the others are EMPTY_TILE
+	unsigned int	threads		= 0;	//0 uses one per hardware thread
+};
+
+std::string checkMazeSettings(const MazeSettings& settings);
+void generateMaze(const MazeSettings& settings, std::vector<uint8_t>& tiles);
+bool writeLevel(const std::string& path, int width, int height, const std::vector<uint8_t>& tiles, unsigned int threads = 0);
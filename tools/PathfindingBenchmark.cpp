@@ -0,0 +1,134 @@
+/**
+ * @file PathfindingBenchmark.cpp
+ * @author Sebastian Lindtvedt (lindtvedt.sebastian@gmail.com)
+ * @brief Compares the search modes and open lists of the AStar class and the JunctionGraph on level0 and on generated mazes.
+ * @version 0.1
+ * @date 2020-11-17
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "BenchmarkLevels.h"
+#include "../src/Core/JunctionGraph.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Runs every query in one mode and prints the average time and expansions per query.
+ *
+ * @tparam OpenList - The open list AStar is compiled with
+ * @param name 		- Printed in front of the results
+ * @param map 		- The grid to search
+ * @param queries 	- The queries to run
+ * @param mode 		- The search mode to benchmark
+ * @param lengths 	- The path lengths, filled by the first mode and checked by the others
+ */
+template<typename OpenList>
+void runMode(const char* name, const Map& map, const std::vector<PathQuery>& queries, SearchMode mode, std::vector<int>& lengths)
+{
+	BasicAStar<OpenList> astar(map.grid(), mode);
+	std::vector<Node> path(map.tiles.size());
+	bool fill = lengths.empty();
+
+	long long expansions = 0;
+	int mismatches = 0;
+	auto begin = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < queries.size(); i++) {
+		int length = astar.Pathfind(queries[i].start, queries[i].destination, &path[0], path.size());
+		expansions += astar.getLastExpansions();
+		if (fill)
+			lengths.push_back(length);
+		else if (lengths[i] != length)
+			mismatches++;
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double microseconds = std::chrono::duration<double, std::micro>(end - begin).count();
+	std::cout << "  " << std::left << std::setw(20) << name
+			  << std::right << std::fixed << std::setprecision(2)
+			  << std::setw(12) << microseconds / queries.size() << " us/query"
+			  << std::setw(12) << (double)expansions / queries.size() << " expansions/query";
+	if (!fill)
+		std::cout << "  (" << mismatches << " path lengths differ)";
+	std::cout << "\n";
+}
+
+/**
+ * @brief 	Runs every query on the JunctionGraph of the grid (without the tunnel, like AStar)
+ * 			and prints the average time and nodes expanded per query next to the AStar modes.
+ *
+ * @param map 		- The grid to search
+ * @param queries 	- The queries to run
+ * @param lengths 	- The path lengths found by AStar, checked against the graph's
+ */
+void runJunctionGraph(const Map& map, const std::vector<PathQuery>& queries, const std::vector<int>& lengths)
+{
+	auto begin = std::chrono::steady_clock::now();
+	JunctionGraph graph(map.grid(), false);
+	auto built = std::chrono::steady_clock::now();
+
+	long long expansions = 0;
+	int mismatches = 0;
+	FlowStep step;
+	for (size_t i = 0; i < queries.size(); i++) {
+		int length = graph.FindPath(queries[i].start.y, queries[i].start.x, queries[i].destination.y, queries[i].destination.x, step);
+		expansions += graph.getLastExpansions();
+		if (lengths[i] != length + 1)	//AStar counts the nodes of the path, the graph the steps
+			mismatches++;
+	}
+	auto end = std::chrono::steady_clock::now();
+
+	double microseconds = std::chrono::duration<double, std::micro>(end - built).count();
+	std::cout << "  " << std::left << std::setw(20) << "JunctionGraph"
+			  << std::right << std::fixed << std::setprecision(2)
+			  << std::setw(12) << microseconds / queries.size() << " us/query"
+			  << std::setw(12) << (double)expansions / queries.size() << " expansions/query"
+			  << "  (" << mismatches << " path lengths differ, " << graph.getNodeCount() << " nodes, "
+			  << graph.getEdgeCount() << " edges, built in "
+			  << std::chrono::duration<double, std::milli>(built - begin).count() << " ms)\n";
+}
+
+/**
+ * @brief Benchmarks both modes with both open lists, and the JunctionGraph, on one grid.
+ *
+ * @param name 		- Printed in front of the results
+ * @param map 		- The grid to search
+ * @param queries 	- How many random queries to run
+ * @param rng 		- Random generator
+ */
+void benchmark(const std::string& name, const Map& map, int queries, std::mt19937& rng)
+{
+	std::cout << name << " (" << map.width << "x" << map.height << ")\n";
+	std::vector<PathQuery> list = makeQueries(map, queries, rng);
+	std::vector<int> lengths;
+	runMode<BinaryHeap>("Standard, heap", map, list, SearchMode::Standard, lengths);
+	runMode<BucketQueue>("Standard, buckets", map, list, SearchMode::Standard, lengths);
+	runMode<BinaryHeap>("JumpPoint, heap", map, list, SearchMode::JumpPoint, lengths);
+	runMode<BucketQueue>("JumpPoint, buckets", map, list, SearchMode::JumpPoint, lengths);
+	runJunctionGraph(map, list, lengths);
+}
+
+int main(int argc, char** argv)
+{
+	//The levels to load, e.g. level0 and one made by mazegen
+	std::vector<std::string> levels(argv + 1, argv + argc);
+	if (levels.empty())
+		levels.push_back("levels/level0");
+	std::mt19937 rng(1234);
+
+	for (const auto& level : levels) {
+		ScenarioLoader scenario(level);
+		if (scenario.getVecSize() > 0)
+			benchmark(level, loadLevel(scenario), scenario.getVecSize() <= 64 * 64 ? 10000 : 200, rng);
+	}
+
+	benchmark("corridor maze", makeCorridorMaze(512, 0.0f, rng), 200, rng);
+	benchmark("corridor maze, 10% loops", makeCorridorMaze(512, 0.1f, rng), 200, rng);
+	benchmark("open level", makeOpenLevel(512, 1500, rng), 200, rng);
+	return 0;
+}